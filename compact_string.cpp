@@ -0,0 +1,191 @@
+/**@file src/compact_string.cpp
+ * @author Nosov Yuri <hoxnox@gmail.com>
+ * @date 2026-10-17
+ * @copyright (c) 2026 Nosov Yuri <hoxnox@gmail.com>
+ * @licence ENTY licence
+ *
+ * @brief CompactString implementation*/
+
+#include "compact_string.hpp"
+
+namespace nx{
+
+/**@class CompactString
+ * @brief String of wchar_t characters stored in 1, 2 or 4 bytes each
+ *
+ * Like the flexible string representation of Python, every character takes
+ * as many bytes as the widest one needs. One-byte characters are not
+ * limited to Latin-1: bytes 0x00..0x7F are ASCII, bytes 0x80..0xFF are a
+ * 128-character window chosen by the first non-ASCII character, so
+ * Russian text (window U+0400) takes a byte per character as Latin-1 text
+ * (window U+0080) does. A character that does not fit widens the whole
+ * string; strings are never narrowed back:
+ * @code
+ * CompactString name(dT("Иванов Иван Иванович")); // 20 bytes
+ * name.append(dT(", ул. Ленина"));              // still a byte each
+ * name.push_back(L'№');                         // 2 bytes each
+ * String str = name.toString();
+ * @endcode
+ * Characters are wchar_t code units: on 16-bit wchar_t a surrogate pair is
+ * two 2-byte characters.*/
+
+CompactString::CompactString()
+	: unit_width(1),
+	  window(0)
+{
+}
+
+/**@brief Construct CompactString from std::wstring (and String).*/
+CompactString::CompactString(const std::wstring& str)
+	: unit_width(1),
+	  window(0)
+{
+	append(str.data(), str.size());
+}
+
+/**@brief Construct CompactString from const wchar_t*.*/
+CompactString::CompactString(const wchar_t * s, size_t n)
+	: unit_width(1),
+	  window(0)
+{
+	append(s, n);
+}
+
+/**@brief Construct CompactString from const wchar_t*.*/
+CompactString::CompactString(const wchar_t * s)
+	: unit_width(1),
+	  window(0)
+{
+	append(s, std::wcslen(s));
+}
+
+/**@brief Convert to String.*/
+String CompactString::toString() const
+{
+	const size_t n = size();
+	String str(n, L'\0');
+	const char* p = units.data();
+	for(size_t i = 0; i < n; ++i, p += unit_width)
+		str[i] = get(p, unit_width, window);
+	return str;
+}
+
+/**@brief Replace i-th character with c, widening the string if c does not
+ * fit.*/
+void CompactString::set(size_t i, wchar_t c)
+{
+	size_t w = unit_width;
+	unsigned long win = window;
+	fit(&c, 1, w, win);
+	widen(w, win);
+	put(&units[i * unit_width], unit_width, window, c);
+}
+
+void CompactString::push_back(wchar_t c)
+{
+	append(&c, 1);
+}
+
+/**@brief Append n characters of s, widening the string once if any of
+ * them does not fit.*/
+CompactString& CompactString::append(const wchar_t * s, size_t n)
+{
+	size_t w = unit_width;
+	unsigned long win = window;
+	fit(s, n, w, win);
+	widen(w, win);
+	if(n == 0)
+		return *this;
+	const size_t pos = units.size();
+	units.resize(pos + n * unit_width);
+	char* p = &units[0] + pos;
+	for(size_t i = 0; i < n; ++i, p += unit_width)
+		put(p, unit_width, window, s[i]);
+	return *this;
+}
+
+CompactString& CompactString::append(const std::wstring& str)
+{
+	return append(str.data(), str.size());
+}
+
+/**@brief Reserve space for n characters of the current width.*/
+void CompactString::reserve(size_t n)
+{
+	units.reserve(n * unit_width);
+}
+
+/**@brief Remove all characters, the width is kept.*/
+void CompactString::clear()
+{
+	units.clear();
+}
+
+bool CompactString::operator==(const CompactString& str) const
+{
+	if(unit_width == str.unit_width && (unit_width != 1 || window == str.window))
+		return units == str.units;
+	const size_t n = size();
+	if(n != str.size())
+		return false;
+	for(size_t i = 0; i < n; ++i)
+		if(operator[](i) != str[i])
+			return false;
+	return true;
+}
+
+/**@brief Lexicographical comparison, the same as of std::wstring.*/
+bool CompactString::operator<(const CompactString& str) const
+{
+	const size_t n = std::min(size(), str.size());
+	for(size_t i = 0; i < n; ++i)
+	{
+		const wchar_t a = operator[](i), b = str[i];
+		if(a != b)
+			return a < b;
+	}
+	return size() < str.size();
+}
+
+/**@brief Narrowest width and window holding n characters of s besides the
+ * ones already held.
+ * @param w current width, receives the required one
+ * @param win current window, receives the required one*/
+void CompactString::fit(const wchar_t* s, size_t n, size_t& w,
+                        unsigned long& win)
+{
+	for(size_t i = 0; i < n && w < sizeof(wchar_t); ++i)
+	{
+		const unsigned long c = static_cast<unsigned long>(s[i]);
+		if(c > 0xFFFF)
+			w = sizeof(wchar_t);
+		else if(w == 1 && c >= 0x80)
+		{
+			if(win == 0)
+				win = c & ~0x7FUL;
+			else if(c - win >= 0x80)
+				w = 2;
+		}
+	}
+}
+
+/**@brief Re-encode characters with width w and window win.*/
+void CompactString::widen(size_t w, unsigned long win)
+{
+	if(w == unit_width)
+	{
+		// a window is only set on the first non-ASCII character
+		window = win;
+		return;
+	}
+	const size_t n = size();
+	std::string wide(n * w, '\0');
+	const char* from = units.data();
+	for(size_t i = 0; i < n; ++i, from += unit_width)
+		put(&wide[i * w], w, win, get(from, unit_width, window));
+	units.swap(wide);
+	unit_width = w;
+	window = win;
+}
+
+} //namespace nx
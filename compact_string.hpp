@@ -0,0 +1,141 @@
+/**@file include/compact_string.hpp
+ * @author Nosov Yuri <hoxnox@gmail.com>
+ * @date 2026-10-17
+ * @copyright (c) 2026 Nosov Yuri <hoxnox@gmail.com>
+ * @licence Querier licence
+ *
+ * @brief String stored in 1, 2 or 4 bytes per character.*/
+
+#ifndef __NX_COMPACT_STRING_H__
+#define __NX_COMPACT_STRING_H__
+
+#include "string.hpp"
+
+// STL
+#include <cstring>
+#include <cwchar>
+#include <string>
+
+namespace nx{
+
+class CompactString
+{
+public:
+
+	/**@name ctors
+	 * @{*/
+	CompactString();
+	CompactString(const std::wstring& str);
+	CompactString(const wchar_t * s, size_t n);
+	CompactString(const wchar_t * s);
+	/**@}*/
+
+	/**@name access
+	 * @{*/
+	size_t size() const;
+	bool empty() const;
+	size_t width() const;
+	wchar_t operator[](size_t i) const;
+	String toString() const;
+	/**@}*/
+
+	/**@name modification
+	 * @{*/
+	void set(size_t i, wchar_t c);
+	void push_back(wchar_t c);
+	CompactString& append(const wchar_t * s, size_t n);
+	CompactString& append(const std::wstring& str);
+	void reserve(size_t n);
+	void clear();
+	/**@}*/
+
+	bool operator==(const CompactString& str) const;
+	bool operator!=(const CompactString& str) const;
+	bool operator<(const CompactString& str) const;
+
+private:
+
+	static wchar_t get(const char* p, size_t w, unsigned long win);
+	static void put(char* p, size_t w, unsigned long win, wchar_t c);
+	static void fit(const wchar_t* s, size_t n, size_t& w,
+	                unsigned long& win);
+	void widen(size_t w, unsigned long win);
+
+	std::string units;      // code units, unit_width bytes each
+	size_t unit_width;      // 1, 2 or sizeof(wchar_t)
+	unsigned long window;   // first character of bytes 0x80..0xFF, 0 if unset
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// inline
+
+/**@brief Number of characters (wchar_t code units).*/
+inline size_t CompactString::size() const
+{
+	return units.size() / unit_width;
+}
+
+inline bool CompactString::empty() const
+{
+	return units.empty();
+}
+
+/**@brief Bytes per character: 1, 2 or sizeof(wchar_t).*/
+inline size_t CompactString::width() const
+{
+	return unit_width;
+}
+
+inline wchar_t CompactString::operator[](size_t i) const
+{
+	return get(units.data() + i * unit_width, unit_width, window);
+}
+
+inline bool CompactString::operator!=(const CompactString& str) const
+{
+	return !operator==(str);
+}
+
+/**@brief Character stored at p.*/
+inline wchar_t CompactString::get(const char* p, size_t w,
+                                  unsigned long win)
+{
+	if(w == 1)
+	{
+		const unsigned char b = static_cast<unsigned char>(*p);
+		return static_cast<wchar_t>(b < 0x80 ? b : win + b - 0x80);
+	}
+	if(w == 2)
+	{
+		unsigned short u;
+		std::memcpy(&u, p, sizeof(u));
+		return static_cast<wchar_t>(u);
+	}
+	wchar_t c;
+	std::memcpy(&c, p, sizeof(c));
+	return c;
+}
+
+/**@brief Store c at p, c must fit into width w and window win.*/
+inline void CompactString::put(char* p, size_t w, unsigned long win,
+                               wchar_t c)
+{
+	const unsigned long u = static_cast<unsigned long>(c);
+	if(w == 1)
+	{
+		*p = static_cast<char>(u < 0x80 ? u : u - win + 0x80);
+	}
+	else if(w == 2)
+	{
+		const unsigned short s = static_cast<unsigned short>(u);
+		std::memcpy(p, &s, sizeof(s));
+	}
+	else
+	{
+		std::memcpy(p, &c, sizeof(c));
+	}
+}
+
+} // namespace nx
+
+#endif // __NX_COMPACT_STRING_H__
@@ -0,0 +1,35 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Codecvt cp1252 facet implementation.
+ *
+ * This file is a part of hoxnox's facets project*/
+
+#ifndef __CODECVT_CP1252_HPP__
+#define __CODECVT_CP1252_HPP__
+
+#include <codecvt/codecvt_sbcs.hpp>
+
+/**@brief cp1252 table, see codecvt_sbcs*/
+struct sbcs_cp1252
+{
+  static const wchar_t* upper()
+  {
+    static const wchar_t tab[128] =
+    {
+#define SBCS_MAP(b, u) u,
+#include <codecvt/sbcs/cp1252.def>
+#undef SBCS_MAP
+    };
+    return tab;
+  }
+};
+
+/**@brief Facet is used to convert western european char strings in
+ * cp1252 encoding into UNICODE*/
+typedef codecvt_sbcs<sbcs_cp1252> codecvt_cp1252;
+
+/**@brief cp1252 conversion without std::locale, see sbcs_codec*/
+typedef sbcs_codec<sbcs_cp1252> codec_cp1252;
+
+#endif // __CODECVT_CP1252_HPP__
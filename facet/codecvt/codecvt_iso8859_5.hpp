@@ -0,0 +1,35 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Codecvt ISO-8859-5 facet implementation.
+ *
+ * This file is a part of hoxnox's facets project*/
+
+#ifndef __CODECVT_ISO8859_5_HPP__
+#define __CODECVT_ISO8859_5_HPP__
+
+#include <codecvt/codecvt_sbcs.hpp>
+
+/**@brief iso8859_5 table, see codecvt_sbcs*/
+struct sbcs_iso8859_5
+{
+  static const wchar_t* upper()
+  {
+    static const wchar_t tab[128] =
+    {
+#define SBCS_MAP(b, u) u,
+#include <codecvt/sbcs/iso8859_5.def>
+#undef SBCS_MAP
+    };
+    return tab;
+  }
+};
+
+/**@brief Facet is used to convert cyrillic char strings in
+ * ISO-8859-5 encoding into UNICODE*/
+typedef codecvt_sbcs<sbcs_iso8859_5> codecvt_iso8859_5;
+
+/**@brief ISO-8859-5 conversion without std::locale, see sbcs_codec*/
+typedef sbcs_codec<sbcs_iso8859_5> codec_iso8859_5;
+
+#endif // __CODECVT_ISO8859_5_HPP__
@@ -0,0 +1,35 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Codecvt KOI8-U facet implementation.
+ *
+ * This file is a part of hoxnox's facets project*/
+
+#ifndef __CODECVT_KOI8U_HPP__
+#define __CODECVT_KOI8U_HPP__
+
+#include <codecvt/codecvt_sbcs.hpp>
+
+/**@brief koi8u table, see codecvt_sbcs*/
+struct sbcs_koi8u
+{
+  static const wchar_t* upper()
+  {
+    static const wchar_t tab[128] =
+    {
+#define SBCS_MAP(b, u) u,
+#include <codecvt/sbcs/koi8u.def>
+#undef SBCS_MAP
+    };
+    return tab;
+  }
+};
+
+/**@brief Facet is used to convert ukrainian char strings in koi8-u
+ * encoding into UNICODE*/
+typedef codecvt_sbcs<sbcs_koi8u> codecvt_koi8u;
+
+/**@brief koi8-u conversion without std::locale, see sbcs_codec*/
+typedef sbcs_codec<sbcs_koi8u> codec_koi8u;
+
+#endif // __CODECVT_KOI8U_HPP__
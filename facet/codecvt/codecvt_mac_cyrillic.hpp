@@ -0,0 +1,35 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Codecvt MacCyrillic facet implementation.
+ *
+ * This file is a part of hoxnox's facets project*/
+
+#ifndef __CODECVT_MAC_CYRILLIC_HPP__
+#define __CODECVT_MAC_CYRILLIC_HPP__
+
+#include <codecvt/codecvt_sbcs.hpp>
+
+/**@brief mac_cyrillic table, see codecvt_sbcs*/
+struct sbcs_mac_cyrillic
+{
+  static const wchar_t* upper()
+  {
+    static const wchar_t tab[128] =
+    {
+#define SBCS_MAP(b, u) u,
+#include <codecvt/sbcs/mac_cyrillic.def>
+#undef SBCS_MAP
+    };
+    return tab;
+  }
+};
+
+/**@brief Facet is used to convert cyrillic char strings in
+ * MacCyrillic encoding into UNICODE*/
+typedef codecvt_sbcs<sbcs_mac_cyrillic> codecvt_mac_cyrillic;
+
+/**@brief MacCyrillic conversion without std::locale, see sbcs_codec*/
+typedef sbcs_codec<sbcs_mac_cyrillic> codec_mac_cyrillic;
+
+#endif // __CODECVT_MAC_CYRILLIC_HPP__
@@ -0,0 +1,247 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Codecvt facet of single-byte codepages.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * Every single-byte codepage is the same engine with its own table. A
+ * table is a class with the static member upper(), returning UNICODE
+ * characters of bytes 0x80..0xFF (0 for unmapped ones), built at compile
+ * time from a generated mapping file:
+ * @code
+ *  struct sbcs_cp1251
+ *  {
+ *    static const wchar_t* upper()
+ *    {
+ *      static const wchar_t tab[128] =
+ *      {
+ *  #define SBCS_MAP(b, u) u,
+ *  #include <codecvt/sbcs/cp1251.def>
+ *  #undef SBCS_MAP
+ *      };
+ *      return tab;
+ *    }
+ *  };
+ *  typedef codecvt_sbcs<sbcs_cp1251> codecvt_cp1251;
+ * @endcode
+ * Mapping files are made by tools/sbcs_def.py from the unicode.org
+ * mapping tables. Bytes 0x00..0x7F are ASCII in every codepage.
+ *
+ * The conversion itself is in sbcs_codec, usable without std::locale
+ * (no use_facet() lookups, no locale reference counting), the facet only
+ * forwards to it:
+ * @code
+ *  sbcs_codec<sbcs_cp1251>::in(from, from_end, from_next,
+ *                              to, to_end, to_next);
+ * @endcode*/
+
+#ifndef __CODECVT_SBCS_HPP__
+#define __CODECVT_SBCS_HPP__
+
+#include <algorithm>
+#include <locale>
+
+#include <codecvt/sbcs_table.hpp>
+#include <simd/sbcs_simd.hpp>
+
+/**@brief Conversion between a single-byte codepage described by Table
+ * and UNICODE
+ *
+ * The functions work like the members of std::codecvt with the same
+ * names. Unit is the wide code unit, wchar_t, char16_t or char32_t.*/
+template <class Table>
+struct sbcs_codec
+{
+  /**@brief Byte to UNICODE table of the codepage, built on the first
+   * call*/
+  static const sbcs_planes& in_table()
+  {
+    static const sbcs_planes tab(Table::upper());
+    return tab;
+  }
+
+  /**@brief UNICODE to byte table of the codepage, built on the first
+   * call*/
+  static const sbcs_out_table& out_table()
+  {
+    static const sbcs_out_table tab(Table::upper());
+    return tab;
+  }
+
+  /**@brief Translate bytes into UNICODE
+   * @return std::codecvt_base::ok when the whole input is converted,
+   * partial when the output is full, error on an unmapped byte (from_next
+   * points to it)*/
+  template <class Unit>
+  static std::codecvt_base::result in(const char* from,
+                                      const char* from_end,
+                                      const char* &from_next,
+                                      Unit* to,
+                                      Unit* to_end,
+                                      Unit* &to_next)
+  {
+    const char* end = from + std::min(from_end - from, to_end - to);
+    const size_t done = sbcs_decode(from, end, to, in_table());
+    from_next = from + done;
+    to_next = to + done;
+    if(from_next == from_end)
+      return std::codecvt_base::ok;
+    return from_next == end ? std::codecvt_base::partial
+                            : std::codecvt_base::error;
+  }
+
+  /**@brief Translate UNICODE into bytes
+   * @return std::codecvt_base::ok when the whole input is converted,
+   * partial when the output is full, error on a character missing in the
+   * codepage (from_next points to it)*/
+  template <class Unit>
+  static std::codecvt_base::result out(const Unit* from,
+                                       const Unit* from_end,
+                                       const Unit* &from_next,
+                                       char* to,
+                                       char* to_end,
+                                       char* &to_next)
+  {
+    const Unit* end = from + std::min(from_end - from, to_end - to);
+    const size_t done = sbcs_encode(from, end, to, out_table());
+    from_next = from + done;
+    to_next = to + done;
+    if(from_next == from_end)
+      return std::codecvt_base::ok;
+    return from_next == end ? std::codecvt_base::partial
+                            : std::codecvt_base::error;
+  }
+
+  /**@brief Number of bytes in [from, from_end) making at most max
+   * characters, stops before an unmapped byte*/
+  static size_t length(const char* from, const char* from_end, size_t max)
+  {
+    const sbcs_planes& tab = in_table();
+    const size_t n = std::min(static_cast<size_t>(from_end - from), max);
+    if(tab.complete)
+      return n;
+    size_t i = 0;
+    for(; i != n; ++i)
+    {
+      const unsigned char c = static_cast<unsigned char>(from[i]);
+      if(c > 0x7F && tab.upper[c - 0x80] == 0)
+        break;
+    }
+    return i;
+  }
+
+  /**@brief Maximum number of bytes per character*/
+  static int max_length()
+  {
+    return 1;
+  }
+};
+
+/**@brief Facet is used to convert char strings in a single-byte codepage
+ * described by Table into UNICODE*/
+template <class Table>
+class codecvt_sbcs : public std::codecvt<wchar_t, char, mbstate_t>
+{
+  public:
+
+    typedef std::codecvt_base::result result;
+    const result ok, partial, error, noconv;
+
+    typedef sbcs_codec<Table> codec;
+
+    explicit codecvt_sbcs(size_t r=0)
+      : std::codecvt<wchar_t, char, mbstate_t>(r),
+        ok(std::codecvt_base::ok),
+        partial(std::codecvt_base::partial),
+        error(std::codecvt_base::error),
+        noconv(std::codecvt_base::noconv)
+    {
+      // build the tables before the facet is shared between threads
+      codec::in_table();
+      codec::out_table();
+    }
+
+    ~codecvt_sbcs()
+    {
+    }
+
+    /**@brief Byte to UNICODE table of the codepage*/
+    static const sbcs_planes& in_table()
+    {
+      return codec::in_table();
+    }
+
+    /**@brief UNICODE to byte table of the codepage*/
+    static const sbcs_out_table& out_table()
+    {
+      return codec::out_table();
+    }
+
+
+protected:
+
+
+  virtual result do_in(mbstate_t&,
+                       const char* from,
+                       const char* from_end,
+                       const char* &from_next,
+                       wchar_t* to,
+                       wchar_t* to_end,
+                       wchar_t* &to_next)
+    const
+  {
+    return codec::in(from, from_end, from_next, to, to_end, to_next);
+  }
+
+
+  virtual result do_out(mbstate_t&,
+                        const wchar_t* from,
+                        const wchar_t* from_end,
+                        const wchar_t* &from_next,
+                        char* to,
+                        char* to_end,
+                        char* &to_next)
+    const
+  {
+    return codec::out(from, from_end, from_next, to, to_end, to_next);
+  }
+
+  virtual result do_unshift(mbstate_t&,
+                            char* to,
+                            char*,
+                            char* &to_next)
+    const
+  {
+    // no shift states
+    to_next = to;
+    return noconv;
+  }
+
+  virtual int do_encoding() const throw()
+  {
+    // one byte per character
+    return 1;
+  }
+
+  virtual bool do_always_noconv() const throw()
+  {
+    return false;
+  }
+
+  virtual int do_length(mbstate_t&,
+                        const char* from,
+                        const char* from_end,
+                        size_t max)
+    const
+  {
+    return static_cast<int>(codec::length(from, from_end, max));
+  }
+
+  virtual int do_max_length() const throw()
+  {
+    return codec::max_length();
+  }
+};
+
+#endif // __CODECVT_SBCS_HPP__
@@ -0,0 +1,161 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Codecvt UTF-8 facet implementation.
+ *
+ * This file is a part of hoxnox's facets project*/
+
+#ifndef __CODECVT_UTF8_HPP__
+#define __CODECVT_UTF8_HPP__
+
+#include <locale>
+
+#include <codecvt/mbwcvt.hpp>
+
+/**@brief Conversion between UTF-8 and UNICODE
+ *
+ * The functions work like the members of std::codecvt with the same
+ * names, without std::locale. Unit is the wide code unit, wchar_t,
+ * char16_t or char32_t. A sequence cut by from_end is left unconsumed and
+ * in() returns partial.*/
+struct utf8_codec
+{
+  template <class Unit>
+  static std::codecvt_base::result in(const char* from,
+                                      const char* from_end,
+                                      const char* &from_next,
+                                      Unit* to,
+                                      Unit* to_end,
+                                      Unit* &to_next)
+  {
+    cvt_status status;
+    return utf8_in<cvt_stop>(from, from_end, from_next,
+                             to, to_end, to_next, status, false);
+  }
+
+  template <class Unit>
+  static std::codecvt_base::result out(const Unit* from,
+                                       const Unit* from_end,
+                                       const Unit* &from_next,
+                                       char* to,
+                                       char* to_end,
+                                       char* &to_next)
+  {
+    return utf8_out(from, from_end, from_next, to, to_end, to_next);
+  }
+
+  /**@brief Number of bytes in [from, from_end) making at most max wchar_t
+   * units*/
+  static size_t length(const char* from, const char* from_end, size_t max)
+  {
+    return utf8_length<wchar_t>(from, from_end, max);
+  }
+
+  /**@brief Maximum number of bytes per character*/
+  static int max_length()
+  {
+    return 4;
+  }
+};
+
+/**@brief Facet is used to convert UTF-8 char strings into UNICODE
+ *
+ * Whole buffers are converted by the block routines of mbwcvt.hpp, so
+ * wide file streams and wbuffer_convert get the SIMD paths:
+ * @code
+ *  std::wifstream in;
+ *  in.imbue(std::locale(std::locale(), new codecvt_utf8));
+ *  in.open("file.txt");
+ * @endcode
+ * A sequence cut by the end of a buffer is left unconsumed and do_in
+ * returns partial, so the stream hands it back with the next block and
+ * no conversion state is kept in mbstate_t. Invalid sequences, unpaired
+ * surrogates and characters above U+10FFFF are errors. When wchar_t is
+ * 16-bit, characters above U+FFFF are surrogate pairs.*/
+class codecvt_utf8 : public std::codecvt<wchar_t, char, mbstate_t>
+{
+  public:
+
+    typedef std::codecvt_base::result result;
+    const result ok, partial, error, noconv;
+
+    explicit codecvt_utf8(size_t r=0)
+      : std::codecvt<wchar_t, char, mbstate_t>(r),
+        ok(std::codecvt_base::ok),
+        partial(std::codecvt_base::partial),
+        error(std::codecvt_base::error),
+        noconv(std::codecvt_base::noconv)
+    {
+    }
+
+    ~codecvt_utf8()
+    {
+    }
+
+
+protected:
+
+
+  virtual result do_in(mbstate_t&,
+                       const char* from,
+                       const char* from_end,
+                       const char* &from_next,
+                       wchar_t* to,
+                       wchar_t* to_end,
+                       wchar_t* &to_next)
+    const
+  {
+    return utf8_codec::in(from, from_end, from_next, to, to_end, to_next);
+  }
+
+
+  virtual result do_out(mbstate_t&,
+                        const wchar_t* from,
+                        const wchar_t* from_end,
+                        const wchar_t* &from_next,
+                        char* to,
+                        char* to_end,
+                        char* &to_next)
+    const
+  {
+    return utf8_codec::out(from, from_end, from_next, to, to_end, to_next);
+  }
+
+  virtual result do_unshift(mbstate_t&,
+                            char* to,
+                            char*,
+                            char* &to_next)
+    const
+  {
+    // no shift states
+    to_next = to;
+    return noconv;
+  }
+
+  virtual int do_encoding() const throw()
+  {
+    // variable length
+    return 0;
+  }
+
+  virtual bool do_always_noconv() const throw()
+  {
+    return false;
+  }
+
+  virtual int do_length(mbstate_t&,
+                        const char* from,
+                        const char* from_end,
+                        size_t max)
+    const
+  {
+    return static_cast<int>(utf8_codec::length(from, from_end, max));
+  }
+
+  virtual int do_max_length() const throw()
+  {
+    return utf8_codec::max_length();
+  }
+};
+
+#endif // __CODECVT_UTF8_HPP__
@@ -0,0 +1,51 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Error policies shared by the conversion routines.
+ *
+ * This file is a part of hoxnox's facets project*/
+
+#ifndef __CVT_ERROR_HPP__
+#define __CVT_ERROR_HPP__
+
+#include <cstddef>
+
+/**@brief What a converter does with input it can't convert*/
+enum cvt_error_policy
+{
+  cvt_replace, // emit a replacement character and go on
+  cvt_skip,    // drop the bad input and go on
+  cvt_stop     // stop before the bad input
+};
+
+/**@brief Conversion report
+ *
+ * error_offset is the offset of the first bad input element, it stays
+ * npos while errors is zero. Callers converting input in chunks keep the
+ * offset of the current chunk in base, so reported offsets are counted
+ * from the start of the whole input.*/
+struct cvt_status
+{
+  static const size_t npos = static_cast<size_t>(-1);
+
+  size_t errors;
+  size_t error_offset;
+  size_t base;
+
+  cvt_status()
+    : errors(0),
+      error_offset(npos),
+      base(0)
+  {
+  }
+
+  /**@brief Record a bad input element at offset from the start of the
+   * whole input*/
+  void fail(size_t offset)
+  {
+    if(errors++ == 0)
+      error_offset = offset;
+  }
+};
+
+#endif // __CVT_ERROR_HPP__
@@ -0,0 +1,166 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Encoding detection of Cyrillic text.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * The detector makes one pass over the text: ASCII runs are skipped by
+ * blocks, other bytes go to a histogram and through the UTF-8 automaton.
+ * Valid UTF-8 with multibyte characters is taken as UTF-8. Otherwise the
+ * histogram is scored against Russian letter frequencies as read in each
+ * single-byte candidate, the most likely one wins:
+ * @code
+ *  const encoding_guess guess = detect_encoding(text, text + size);
+ *  if(guess.encoding == encoding_cp866 && guess.confidence > 0.9)
+ *    ...
+ * @endcode
+ * Only the first limit bytes are examined, a few kilobytes are enough to
+ * tell the candidates apart.*/
+
+#ifndef __DETECT_HPP__
+#define __DETECT_HPP__
+
+#include <cmath>
+#include <cstddef>
+
+#include <codecvt/codecvt_cp1251.hpp>
+#include <codecvt/codecvt_cp866.hpp>
+#include <codecvt/codecvt_koi8r.hpp>
+#include <codecvt/mbwcvt.hpp>
+#include <simd/utf8_simd.hpp>
+
+/**@brief Encodings told apart by detect_encoding()*/
+enum encoding_id
+{
+  encoding_unknown, // empty input
+  encoding_ascii,   // 7-bit text, readable in every candidate
+  encoding_utf8,
+  encoding_cp1251,
+  encoding_cp866,
+  encoding_koi8r
+};
+
+/**@brief Detected encoding and the probability that it is right*/
+struct encoding_guess
+{
+  encoding_id encoding;
+  double confidence; // 0..1
+
+  encoding_guess(encoding_id e = encoding_unknown, double c = 0)
+    : encoding(e),
+      confidence(c)
+  {
+  }
+};
+
+/**@brief Log-probabilities of the bytes 0x80..0xFF of a single-byte
+ * codepage in Russian text*/
+struct detect_model
+{
+  double logp[128];
+
+  explicit detect_model(const wchar_t* upper)
+  {
+    // letter frequencies in percent, U+0430..U+044F
+    static const double freq[32] =
+    {
+      8.01, 1.59, 4.54, 1.70, 2.98, 8.45, 0.94, 1.65, // U+0430..U+0437
+      7.35, 1.21, 3.49, 4.40, 3.21, 6.70, 10.97, 2.81, // U+0438..U+043F
+      4.73, 5.47, 6.26, 2.62, 0.26, 0.97, 0.48, 1.44, // U+0440..U+0447
+      0.73, 0.36, 0.04, 1.90, 1.74, 0.32, 0.64, 2.01  // U+0448..U+044F
+    };
+    for(int b = 0; b < 128; ++b)
+    {
+      const unsigned long c = static_cast<unsigned long>(upper[b]);
+      double p = 0.001; // punctuation, pseudographics
+      if(c == 0)
+        p = 0.000001;
+      else if(0x430 <= c && c <= 0x44F)
+        p = 0.9 * freq[c - 0x430] / 100;
+      else if(0x410 <= c && c <= 0x42F)
+        p = 0.1 * freq[c - 0x410] / 100;
+      else if(c == 0x451 || c == 0x401)
+        p = 0.0004;
+      else if(0x400 <= c && c <= 0x4FF)
+        p = 0.0002;
+      logp[b] = std::log(p);
+    }
+  }
+
+  /**@brief Log-likelihood of a histogram of the bytes 0x80..0xFF*/
+  double score(const size_t* hist) const
+  {
+    double s = 0;
+    for(int b = 0; b < 128; ++b)
+      s += static_cast<double>(hist[b]) * logp[b];
+    return s;
+  }
+};
+
+/**@brief Guess the encoding of [b, e) among UTF-8, cp1251, cp866 and
+ * KOI8-R, looking at its first limit bytes*/
+inline encoding_guess detect_encoding(const char* b, const char* e,
+                                      size_t limit = 4096)
+{
+  const char* stop = static_cast<size_t>(e - b) > limit ? b + limit : e;
+  if(b == stop)
+    return encoding_guess();
+  size_t hist[128] = {0};
+  size_t high = 0, multibyte = 0;
+  unsigned state = UTF8_ACCEPT, cp = 0;
+  bool utf8 = true;
+  const char* i = b;
+  while(i != stop)
+  {
+    if(static_cast<unsigned char>(*i) <= 0x7F)
+    {
+      // ASCII inside a multibyte sequence
+      if(state != UTF8_ACCEPT)
+        utf8 = false;
+      i += utf8_ascii_length(i, stop);
+      continue;
+    }
+    const unsigned char c = static_cast<unsigned char>(*i++);
+    ++hist[c - 0x80];
+    ++high;
+    if(utf8)
+    {
+      if(utf8_decode(state, cp, c) == UTF8_REJECT)
+        utf8 = false;
+      else if(state == UTF8_ACCEPT)
+        ++multibyte;
+    }
+  }
+  if(high == 0)
+    return encoding_guess(encoding_ascii, 1);
+  // a sequence cut by limit may be complete in the whole input
+  if(state != UTF8_ACCEPT && stop == e)
+    utf8 = false;
+  if(utf8 && multibyte != 0)
+  {
+    // a random single-byte text makes a valid sequence with about 1/8
+    // chance
+    return encoding_guess(encoding_utf8,
+                          1 - std::pow(0.125, static_cast<double>(multibyte)));
+  }
+
+  static const detect_model cp1251(sbcs_cp1251::upper());
+  static const detect_model cp866(sbcs_cp866::upper());
+  static const detect_model koi8r(sbcs_koi8r::upper());
+  const encoding_id ids[3] = { encoding_cp1251, encoding_cp866,
+                               encoding_koi8r };
+  const double score[3] = { cp1251.score(hist), cp866.score(hist),
+                            koi8r.score(hist) };
+  int best = 0;
+  for(int k = 1; k < 3; ++k)
+    if(score[k] > score[best])
+      best = k;
+  // posterior of the best one with equal priors
+  double sum = 0;
+  for(int k = 0; k < 3; ++k)
+    sum += std::exp(score[k] - score[best]);
+  return encoding_guess(ids[best], 1 / sum);
+}
+
+#endif // __DETECT_HPP__
@@ -14,120 +14,777 @@
  *  if(wcstombs(str.begin(), str.end(), 
  *              std::back_inserter(wstr)) != str.end())
  *    // error converting;
+ * @endcode
+ * The wide side may be made of 16-bit code units (UTF-16 wchar_t,
+ * char16_t) or of 32-bit ones (UTF-32 wchar_t, char32_t). Characters
+ * above U+FFFF are written and read as surrogate pairs in the former
+ * case, the choice is made at compile time by the unit size:
+ * @code
+ *  std::u16string text;
+ *  mbstowcs(str.begin(), str.end(), std::back_inserter(text));
  * @endcode*/
 
 #ifndef __MBWCVT_HPP__
 #define __MBWCVT_HPP__
 
+#include <iterator>
+#include <locale>
+#include <string>
+
+#include <codecvt/cvt_error.hpp>
+#include <simd/utf8_simd.hpp>
+
+/**@brief Code unit type written through output_iterator
+ *
+ * Insert iterators have no value_type, the unit is taken from their
+ * container. Other output iterators without one get wchar_t.*/
+template <class value_type, class output_iterator>
+struct mbwcvt_unit_of
+{
+  typedef value_type type;
+};
+
+template <class output_iterator>
+struct mbwcvt_unit_of<void, output_iterator>
+{
+  typedef wchar_t type;
+};
+
+template <class container>
+struct mbwcvt_unit_of<void, std::back_insert_iterator<container> >
+{
+  typedef typename container::value_type type;
+};
+
+template <class container>
+struct mbwcvt_unit_of<void, std::front_insert_iterator<container> >
+{
+  typedef typename container::value_type type;
+};
+
+template <class container>
+struct mbwcvt_unit_of<void, std::insert_iterator<container> >
+{
+  typedef typename container::value_type type;
+};
+
+template <class output_iterator>
+struct mbwcvt_unit
+{
+  typedef typename mbwcvt_unit_of<
+    typename std::iterator_traits<output_iterator>::value_type,
+    output_iterator>::type type;
+};
+
+/**@brief Write code point cp to o as Unit code units
+ *
+ * 16-bit units get a surrogate pair for a code point above U+FFFF.*/
+template <class Unit, class output_iterator>
+inline void utf_put(output_iterator& o, unsigned cp)
+{
+  if(sizeof(Unit) == 2 && cp > 0xFFFF)
+  {
+    cp -= 0x10000;
+    *o = static_cast<Unit>(0xD800 | (cp >> 10));
+    ++o;
+    *o = static_cast<Unit>(0xDC00 | (cp & 0x3FF));
+    ++o;
+    return;
+  }
+  *o = static_cast<Unit>(cp);
+  ++o;
+}
+
+/**@brief Number of Unit code units code point cp takes*/
+template <class Unit>
+inline size_t utf_units(unsigned cp)
+{
+  return (sizeof(Unit) == 2 && cp > 0xFFFF) ? 2 : 1;
+}
+
+/**@brief Encode the leading run of [i, e) below U+0800 to o
+ *
+ * Generic iterators get no fast path: nothing is consumed.*/
+template <class input_iterator, class output_iterator>
+inline void wcstombs_block(input_iterator&,
+                           const input_iterator&,
+                           output_iterator&)
+{
+}
+
+/**@brief Encode the leading run of [i, e) below U+0800 to o using SIMD
+ * kernels*/
+template <class Unit>
+inline void wcstombs_block(const Unit* &i, const Unit* const &e, char* &o)
+{
+  utf8_narrow_block(i, e, o);
+}
+
 /**@brief Translate unicode wide character sequence into byte sequence in
- * UTF-8 encoding*/
+ * UTF-8 encoding
+ * @param o_next receives the output position past the last written byte
+ *
+ * When called with pointer input and char* output, runs of ASCII and
+ * 2-byte characters are encoded by blocks. The output must have room for
+ * the whole result. 16-bit input units are read as UTF-16: a surrogate
+ * pair is encoded as one 4-byte character, an unpaired surrogate as is.*/
 template <class input_iterator, class output_iterator>
 input_iterator wcstombs(const input_iterator& b,
                         const input_iterator& e,
-                        output_iterator o)
+                        output_iterator o,
+                        output_iterator& o_next)
 {
-  typedef typename
-    std::iterator_traits<input_iterator>::value_type intype;
-  typedef typename
-    std::iterator_traits<output_iterator>::value_type outtype;
+  typedef typename std::iterator_traits<input_iterator>::value_type Unit;
+
   input_iterator i(b);
   while(i!=e)
   {
-    if(0 <= *i && *i <= 0x7F)
+    long c = static_cast<long>(*i);
+    if(sizeof(Unit) == 2 && utf16_high_surrogate(*i))
+    {
+      input_iterator low(i);
+      if(++low != e && utf16_low_surrogate(*low))
+      {
+        c = 0x10000 + ((c & 0x3FF) << 10)
+                    + (static_cast<long>(*low) & 0x3FF);
+        i = low;
+      }
+    }
+    if(0 <= c && c <= 0x7FF)
+    {
+      // runs of ASCII and 2-byte characters go by blocks, the scalar
+      // branches below take the character the kernel stops at
+      const input_iterator run = i;
+      wcstombs_block(i, e, o);
+      if(i != run)
+        continue;
+    }
+    if(0 <= c && c <= 0x7F)
+    {
+      *o = static_cast<char>(c);
+    }
+    else if(0x80 <= c && c <=0x7FF)
     {
-        *o = (char)*i;
+         *o = static_cast<char>(0xC0 | (c >> 6));
+      *(++o) = static_cast<char>(0x80 | (c & 0x3F));
     }
-    else if(0x80 <= *i && *i <=0x7FF)
+    else if(0x800 <= c && c <= 0xFFFF)
     {
-         *o = 0xC0 + *i/0x40;
-      *(++o) = 0x80 + *i%0x40;
+         *o = static_cast<char>(0xE0 | (c >> 12));
+      *(++o) = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      *(++o) = static_cast<char>(0x80 | (c & 0x3F));
     }
-    else if(0x800 <= *i && *i <= 0xFFFF)
+    else if(0x10000 <= c && c <= 0x1FFFFF)
     {
-         *o = 0xE0 + *i/(0x40*0x40);
-      *(++o) = 0x80 + (*i%(0x40*0x40))/0x40;
-      *(++o) = 0x80 + *i%0x40;
+         *o = static_cast<char>(0xF0 | (c >> 18));
+      *(++o) = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+      *(++o) = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      *(++o) = static_cast<char>(0x80 | (c & 0x3F));
     }
-    else if(0x10000 <= *i && *i <= 0x1FFFFF)
+    else
     {
-         *o = 0xF0 + *i/(0x40*0x40*0x40);
-      *(++o) = 0x80 + (*i%(0x40*0x40*0x40))/(0x40*0x40);
-      *(++o) = 0x80 + (*i%(0x40*0x40))/0x40;
-      *(++o) = 0x80 + *i%0x40;
+      ++i;
+      continue;
     }
+    ++o;
     ++i;
   }
+  o_next = o;
   return i;
 }
 
-/**@brief Translate byte squence in UTF-8 encoding into wide character
- * unicode sequence*/
+/**@brief Translate unicode wide character sequence into byte sequence in
+ * UTF-8 encoding*/
+template <class input_iterator, class output_iterator>
+input_iterator wcstombs(const input_iterator& b,
+                        const input_iterator& e,
+                        output_iterator o)
+{
+  output_iterator o_next(o);
+  return wcstombs(b, e, o, o_next);
+}
+
+/**@brief Decoder automaton states, see utf8_dfa()*/
+enum
+{
+  UTF8_ACCEPT = 0,
+  UTF8_REJECT = 12
+};
+
+/**@brief Transition table of the validating UTF-8 decoder
+ *
+ * Bjoern Hoehrmann's automaton (http://bjoern.hoehrmann.de/utf-8/decoder/dfa/).
+ * The first 256 entries map a byte to its character class, the rest maps
+ * (state + class) to the next state. Overlong forms, surrogates, code
+ * points above U+10FFFF and stray continuation bytes all lead to
+ * UTF8_REJECT.*/
+inline const unsigned char* utf8_dfa()
+{
+  static const unsigned char table[] =
+  {
+    // 00..7F
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    // 80..BF
+    1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+    7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7, 7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+    // C0..FF
+    8,8,2,2,2,2,2,2,2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,
+    10,3,3,3,3,3,3,3,3,3,3,3,3,4,3,3, 11,6,6,6,5,8,8,8,8,8,8,8,8,8,8,8,
+    // transitions
+     0,12,24,36,60,96,84,12,12,12,48,72, 12,12,12,12,12,12,12,12,12,12,12,12,
+    12, 0,12,12,12,12,12, 0,12, 0,12,12, 12,24,12,12,12,12,12,24,12,24,12,12,
+    12,12,12,12,12,12,12,24,12,12,12,12, 12,24,12,12,12,12,12,12,12,24,12,12,
+    12,12,12,12,12,12,12,36,12,36,12,12, 12,36,12,12,12,12,12,36,12,36,12,12,
+    12,36,12,12,12,12,12,12,12,12,12,12
+  };
+  return table;
+}
+
+/**@brief Feed one byte to the decoder automaton
+ * @param state automaton state, UTF8_ACCEPT at a character boundary
+ * @param cp code point accumulator, complete when the returned state is
+ * UTF8_ACCEPT
+ * @return new state*/
+inline unsigned utf8_decode(unsigned& state, unsigned& cp, unsigned char c)
+{
+  const unsigned char* dfa = utf8_dfa();
+  const unsigned type = dfa[c];
+  cp = (state != UTF8_ACCEPT) ? (c & 0x3Fu) | (cp << 6)
+                              : (0xFFu >> type) & c;
+  state = dfa[256 + state + type];
+  return state;
+}
+
+/**@brief Copy the leading ASCII run of [i, e) to o
+ *
+ * Generic iterators get no fast path: nothing is consumed and the caller
+ * falls back to the byte loop.*/
 template <class input_iterator, class output_iterator>
+inline input_iterator mbstowcs_ascii(input_iterator i,
+                                     input_iterator,
+                                     output_iterator&)
+{
+  return i;
+}
+
+/**@brief Copy the leading ASCII run of [i, e) to o using SIMD kernels*/
+template <class Unit>
+inline const char* mbstowcs_ascii(const char* i,
+                                  const char* e,
+                                  Unit* &o)
+{
+  const size_t n = utf8_widen_ascii(i, e, o);
+  o += n;
+  return i + n;
+}
+
+/**@brief Translate byte squence in UTF-8 encoding into wide character
+ * unicode sequence, validating it
+ * @param policy what to do with an invalid or truncated sequence:
+ * cvt_replace emits U+FFFD for every maximal invalid subpart, cvt_skip
+ * drops it, cvt_stop returns the position of its first byte
+ * @param o_next receives the output position past the last written
+ * character
+ * @param status counts invalid sequences and keeps the offset of the
+ * first one
+ *
+ * Validation and decoding are done in one pass. When called with
+ * const char* input and pointer output, ASCII runs are widened in 16 (32
+ * with AVX2) byte blocks. Characters above U+FFFF become surrogate pairs
+ * if the output code unit is 16-bit.*/
+template <cvt_error_policy policy, class input_iterator,
+          class output_iterator>
 input_iterator mbstowcs(input_iterator b,
                         input_iterator e,
-                        output_iterator o)
+                        output_iterator o,
+                        output_iterator& o_next,
+                        cvt_status& status)
 {
-  input_iterator i = b;
+  typedef unsigned char UChar;
+  typedef typename mbwcvt_unit<output_iterator>::type Unit;
+
+  input_iterator i = b, seq = b;
+  unsigned state = UTF8_ACCEPT, cp = 0;
   while(i != e)
   {
-    typedef
-      typename std::iterator_traits<input_iterator>::value_type Char;
-    typedef
-      typename std::iterator_traits<output_iterator>::value_type WChar;
-    typedef unsigned char UChar;
-
-    if(0x0 <= static_cast<UChar>(*i) && static_cast<UChar>(*i) <= 0x7F)
-    {
-      *o = static_cast<UChar>(*i);
-    }
-    else if(static_cast<UChar>(*i)/0x20 == 0x6) // meet 110xxxxx byte
-    {
-      /* TODO
-      if(sizeof(WChar) < 2*sizeof(Char))
-        return;                   // error
-      */
-      Char first;
-      first = static_cast<UChar>(*i) - 0xC0;
-      if( ++i == e )              // error
-        return i;
-      *o = first*0x40 + (static_cast<UChar>(*i) - 0x80);
-    }
-    else if(static_cast<UChar>(*i)/0x8 == 0xE)  // meet 1110xxxx byte
-    {
-      /* TODO
-      if(sizeof(WChar) < 3*sizeof(Char))
-        return;                   // error
-      */
-      Char first, second;
-      first = static_cast<UChar>(*i) - 0xE0;
-      if( ++i == e )
-        return i;
-      second = static_cast<UChar>(*i) - 0x80;
-      *o = first*(0x40*0x40) + second*0x40
-                            + (static_cast<UChar>(*i) - 0x80);
-    }
-    else if(static_cast<UChar>(*i)/0x4 == 0x1E) // meet 11110xxx byte
-    {
-      /* TODO
-      if(sizeof(WChar) < 4*sizeof(Char))
-        return;                   // error
-      */
-      Char first, second, third;
-      first = static_cast<UChar>(*i) - 0xF0;
-      if( ++i == e )
-        return i;
-      second = static_cast<UChar>(*i) - 0x80;
-      if( ++i == e )
-        return i;
-      third = static_cast<UChar>(*i) - 0x80;
-      if( ++i == e )
-        return i;
-      *o = first*(0x40*0x40*0x40) + second*(0x40*0x40) + third*0x40
-                                 + (static_cast<UChar>(*i) - 0x80);
+    const UChar c = static_cast<UChar>(*i);
+    if(state == UTF8_ACCEPT)
+    {
+      if(c <= 0x7F)
+      {
+        const input_iterator run = mbstowcs_ascii(i, e, o);
+        if(run != i)
+        {
+          i = run;
+          continue;
+        }
+        *o = static_cast<Unit>(c);
+        ++o;
+        ++i;
+        continue;
+      }
+      seq = i;
     }
-    ++i;
+    switch(utf8_decode(state, cp, c))
+    {
+      case UTF8_ACCEPT:
+        utf_put<Unit>(o, cp);
+        ++i;
+        break;
+      case UTF8_REJECT:
+        status.fail(status.base + static_cast<size_t>(std::distance(b, seq)));
+        if(policy == cvt_stop)
+        {
+          o_next = o;
+          return seq;
+        }
+        if(policy == cvt_replace)
+          utf_put<Unit>(o, 0xFFFD);
+        // a lead byte is the whole bad subpart, otherwise the byte that
+        // broke the sequence may start the next one
+        if(i == seq)
+          ++i;
+        state = UTF8_ACCEPT;
+        break;
+      default:
+        ++i;
+    }
+  }
+  if(state != UTF8_ACCEPT)
+  {
+    // truncated sequence at the end of input
+    status.fail(status.base + static_cast<size_t>(std::distance(b, seq)));
+    if(policy == cvt_stop)
+    {
+      o_next = o;
+      return seq;
+    }
+    if(policy == cvt_replace)
+      utf_put<Unit>(o, 0xFFFD);
   }
+  o_next = o;
   return i;
 }
 
+/**@brief Translate byte squence in UTF-8 encoding into wide character
+ * unicode sequence
+ *
+ * Stops at the first invalid or truncated sequence and returns its
+ * position, so the result equals e only for valid input.*/
+template <class input_iterator, class output_iterator>
+input_iterator mbstowcs(input_iterator b,
+                        input_iterator e,
+                        output_iterator o)
+{
+  output_iterator o_next(o);
+  cvt_status status;
+  return mbstowcs<cvt_stop>(b, e, o, o_next, status);
+}
+
+/**@brief State of an interrupted UTF-8 conversion*/
+struct utf8_state
+{
+  unsigned state; // automaton state, UTF8_ACCEPT between characters
+  unsigned cp;    // code point accumulator
+  size_t seq;     // offset of the current sequence, counted as in cvt_status
+
+  utf8_state()
+    : state(UTF8_ACCEPT),
+      cp(0),
+      seq(0)
+  {
+  }
+};
+
+/**@brief Translate UTF-8 buffer into wide characters, resuming from st
+ * @return std::codecvt_base::ok when the whole input is consumed,
+ * partial when the output is full, error when policy is cvt_stop and an
+ * invalid sequence is met
+ *
+ * Works like std::codecvt::in(), but a sequence cut by from_end is
+ * consumed and kept in st, so the next call continues it. status.base
+ * must hold the offset of from in the whole input. Unit is the output code
+ * unit, a character above U+FFFF takes two 16-bit units.*/
+template <cvt_error_policy policy, class Unit>
+std::codecvt_base::result utf8_in(const char* from,
+                                  const char* from_end,
+                                  const char* &from_next,
+                                  Unit* to,
+                                  Unit* to_end,
+                                  Unit* &to_next,
+                                  utf8_state& st,
+                                  cvt_status& status)
+{
+  const char *i = from;
+  while(i != from_end)
+  {
+    const unsigned char c = static_cast<unsigned char>(*i);
+    if(st.state == UTF8_ACCEPT)
+    {
+      if(to == to_end)
+      {
+        from_next = i;
+        to_next = to;
+        return std::codecvt_base::partial;
+      }
+      if(c <= 0x7F)
+      {
+        const size_t room = static_cast<size_t>(to_end - to);
+        const char* run_end = static_cast<size_t>(from_end - i) > room
+                            ? i + room : from_end;
+        const size_t n = utf8_widen_ascii(i, run_end, to);
+        i += n;
+        to += n;
+        continue;
+      }
+      st.seq = status.base + static_cast<size_t>(i - from);
+    }
+    const unsigned state = st.state, cp = st.cp;
+    switch(utf8_decode(st.state, st.cp, c))
+    {
+      case UTF8_ACCEPT:
+        if(static_cast<size_t>(to_end - to) < utf_units<Unit>(st.cp))
+        {
+          // leave the byte completing the character for the next call
+          st.state = state;
+          st.cp = cp;
+          from_next = i;
+          to_next = to;
+          return std::codecvt_base::partial;
+        }
+        utf_put<Unit>(to, st.cp);
+        ++i;
+        break;
+      case UTF8_REJECT:
+        if(policy == cvt_replace && to == to_end)
+        {
+          st.state = state;
+          st.cp = cp;
+          from_next = i;
+          to_next = to;
+          return std::codecvt_base::partial;
+        }
+        status.fail(st.seq);
+        st.state = UTF8_ACCEPT;
+        if(policy == cvt_stop)
+        {
+          // the sequence may have started in a previous chunk
+          from_next = st.seq > status.base
+                    ? from + (st.seq - status.base) : from;
+          to_next = to;
+          return std::codecvt_base::error;
+        }
+        if(policy == cvt_replace)
+          *to++ = static_cast<Unit>(0xFFFD);
+        // a lead byte is the whole bad subpart, otherwise the byte that
+        // broke the sequence may start the next one
+        if(state == UTF8_ACCEPT)
+          ++i;
+        break;
+      default:
+        ++i;
+    }
+  }
+  from_next = from_end;
+  to_next = to;
+  return std::codecvt_base::ok;
+}
+
+/**@brief Report a sequence left unfinished in st at the end of input
+ *
+ * Needs room for one character in the output when policy is
+ * cvt_replace, returns partial otherwise.*/
+template <cvt_error_policy policy, class Unit>
+std::codecvt_base::result utf8_in_flush(Unit* to,
+                                        Unit* to_end,
+                                        Unit* &to_next,
+                                        utf8_state& st,
+                                        cvt_status& status)
+{
+  to_next = to;
+  if(st.state == UTF8_ACCEPT)
+    return std::codecvt_base::ok;
+  if(policy == cvt_replace)
+  {
+    if(to == to_end)
+      return std::codecvt_base::partial;
+    *to_next++ = static_cast<Unit>(0xFFFD);
+  }
+  status.fail(st.seq);
+  st.state = UTF8_ACCEPT;
+  return policy == cvt_stop ? std::codecvt_base::error
+                            : std::codecvt_base::ok;
+}
+
+/**@brief Translate UTF-8 buffer into wide characters with bounded output
+ * @param last false if more input follows, then a sequence cut by
+ * from_end is left unconsumed instead of being reported
+ * @return std::codecvt_base::ok when the whole input is converted,
+ * partial when the output is full or the input ends inside a sequence,
+ * error when policy is cvt_stop and an invalid sequence is met (from_next
+ * points to it)
+ *
+ * Works like std::codecvt::in(): from_next and to_next receive the
+ * positions where conversion stopped. status.base must hold the offset of
+ * from in the whole input. Validation is the same as in mbstowcs(), ASCII
+ * runs are widened by blocks.*/
+template <cvt_error_policy policy, class Unit>
+std::codecvt_base::result utf8_in(const char* from,
+                                  const char* from_end,
+                                  const char* &from_next,
+                                  Unit* to,
+                                  Unit* to_end,
+                                  Unit* &to_next,
+                                  cvt_status& status,
+                                  bool last = true)
+{
+  utf8_state st;
+  std::codecvt_base::result res =
+    utf8_in<policy>(from, from_end, from_next, to, to_end, to_next,
+                    st, status);
+  if(st.state == UTF8_ACCEPT || res == std::codecvt_base::error)
+    return res;
+  // the output filled up inside a sequence, or the input ended in one
+  if(res == std::codecvt_base::partial || !last)
+  {
+    from_next = from + (st.seq - status.base);
+    return std::codecvt_base::partial;
+  }
+  res = utf8_in_flush<policy>(to_next, to_end, to_next, st, status);
+  if(res == std::codecvt_base::partial)
+    from_next = from + (st.seq - status.base);
+  return res;
+}
+
+/**@brief Number of bytes in [from, from_end) holding at most max Unit
+ * code units
+ *
+ * Stops before an invalid sequence and before a sequence cut by from_end,
+ * the way std::codecvt::length() does.*/
+template <class Unit>
+size_t utf8_length(const char* from, const char* from_end, size_t max)
+{
+  const char *i = from;
+  while(i != from_end && max != 0)
+  {
+    if(static_cast<unsigned char>(*i) <= 0x7F)
+    {
+      const char* run_end = static_cast<size_t>(from_end - i) > max
+                          ? i + max : from_end;
+      const size_t n = utf8_ascii_length(i, run_end);
+      i += n;
+      max -= n;
+      continue;
+    }
+    const char* seq = i;
+    unsigned state = UTF8_ACCEPT, cp = 0;
+    do
+      utf8_decode(state, cp, static_cast<unsigned char>(*i++));
+    while(i != from_end && state != UTF8_ACCEPT && state != UTF8_REJECT);
+    if(state != UTF8_ACCEPT || utf_units<Unit>(cp) > max)
+      return static_cast<size_t>(seq - from);
+    max -= utf_units<Unit>(cp);
+  }
+  return static_cast<size_t>(i - from);
+}
+
+/**@brief Translate wide characters into UTF-8 buffer with bounded output
+ * @return std::codecvt_base::ok when the whole input is converted,
+ * partial when the output is full or the input ends inside a surrogate
+ * pair, error when a character can't be encoded (from_next points to it)
+ *
+ * Works like std::codecvt::out(). Unlike wcstombs(), only Unicode scalar
+ * values are accepted: unpaired surrogates and values above U+10FFFF are
+ * errors. Runs below U+0800 are encoded by blocks.*/
+template <class Unit>
+std::codecvt_base::result utf8_out(const Unit* from,
+                                   const Unit* from_end,
+                                   const Unit* &from_next,
+                                   char* to,
+                                   char* to_end,
+                                   char* &to_next)
+{
+  const Unit* i = from;
+  while(i != from_end)
+  {
+    // a block writes at most 2 bytes per character
+    const size_t room = static_cast<size_t>(to_end - to);
+    const Unit* run_end = static_cast<size_t>(from_end - i) > room / 2
+                        ? i + room / 2 : from_end;
+    wcstombs_block(i, run_end, to);
+    if(i == from_end)
+      break;
+    unsigned long c = static_cast<unsigned long>(*i);
+    const Unit* next = i + 1;
+    if(sizeof(Unit) == 2 && utf16_high_surrogate(*i))
+    {
+      if(next == from_end)
+      {
+        from_next = i;
+        to_next = to;
+        return std::codecvt_base::partial;
+      }
+      if(utf16_low_surrogate(*next))
+      {
+        c = 0x10000 + ((c & 0x3FF) << 10)
+                    + (static_cast<unsigned long>(*next) & 0x3FF);
+        ++next;
+      }
+    }
+    if(c > 0x10FFFF || (0xD800 <= c && c <= 0xDFFF))
+    {
+      from_next = i;
+      to_next = to;
+      return std::codecvt_base::error;
+    }
+    const size_t len = 1 + (c > 0x7F) + (c > 0x7FF) + (c > 0xFFFF);
+    if(static_cast<size_t>(to_end - to) < len)
+    {
+      from_next = i;
+      to_next = to;
+      return std::codecvt_base::partial;
+    }
+    switch(len)
+    {
+      case 1:
+        *to++ = static_cast<char>(c);
+        break;
+      case 2:
+        *to++ = static_cast<char>(0xC0 | (c >> 6));
+        *to++ = static_cast<char>(0x80 | (c & 0x3F));
+        break;
+      case 3:
+        *to++ = static_cast<char>(0xE0 | (c >> 12));
+        *to++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        *to++ = static_cast<char>(0x80 | (c & 0x3F));
+        break;
+      default:
+        *to++ = static_cast<char>(0xF0 | (c >> 18));
+        *to++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        *to++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        *to++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    i = next;
+  }
+  from_next = from_end;
+  to_next = to;
+  return std::codecvt_base::ok;
+}
+
+/**@brief Incremental UTF-8 decoder
+ *
+ * Decodes input coming in arbitrary chunks, e.g. socket reads or file
+ * blocks. A sequence split between two chunks is kept in the decoder and
+ * completed by the next call, so every chunk is consumed whole:
+ * @code
+ *  utf8_decoder<cvt_replace> dec;
+ *  std::wstring text;
+ *  while((n = read(fd, buf, sizeof(buf))) > 0)
+ *    dec.decode(buf, buf + n, text);
+ *  dec.finish(text);
+ * @endcode
+ * Error offsets in status() are counted from the start of the stream.
+ * Unit selects the output code unit, e.g. char16_t for UTF-16 text.*/
+template <cvt_error_policy policy, class Unit = wchar_t>
+class utf8_decoder
+{
+  public:
+
+    typedef std::codecvt_base::result result;
+
+    utf8_decoder()
+    {
+    }
+
+    /**@brief Decode next chunk into [to, to_end)
+     *
+     * Same contract as utf8_in() with carried state: partial means the
+     * output is full and decoding must be resumed from from_next.*/
+    result decode(const char* from,
+                  const char* from_end,
+                  const char* &from_next,
+                  Unit* to,
+                  Unit* to_end,
+                  Unit* &to_next)
+    {
+      const result res = utf8_in<policy>(from, from_end, from_next,
+                                         to, to_end, to_next,
+                                         state_, status_);
+      status_.base += static_cast<size_t>(from_next - from);
+      return res;
+    }
+
+    /**@brief Decode next chunk, appending to out
+     * @return false if decoding stopped on an invalid sequence*/
+    bool decode(const char* from,
+                const char* from_end,
+                std::basic_string<Unit>& out)
+    {
+      const size_t size = out.size();
+      // one more for a sequence completed from the previous chunk
+      out.resize(size + utf8_unit_count<Unit>(from, from_end) + 1);
+      const char* from_next = from;
+      Unit* to = &out[0] + size;
+      result res;
+      while((res = decode(from_next, from_end, from_next,
+                          to, &out[0] + out.size(), to))
+            == std::codecvt_base::partial)
+      {
+        // replacement characters outgrew the count
+        const size_t done = static_cast<size_t>(to - &out[0]);
+        out.resize(done + static_cast<size_t>(from_end - from_next) + 1);
+        to = &out[0] + done;
+      }
+      out.resize(static_cast<size_t>(to - &out[0]));
+      return res != std::codecvt_base::error;
+    }
+
+    /**@brief End of input: report a sequence left unfinished
+     * @return partial if there is no room for the replacement character*/
+    result finish(Unit* to, Unit* to_end, Unit* &to_next)
+    {
+      return utf8_in_flush<policy>(to, to_end, to_next, state_, status_);
+    }
+
+    /**@brief End of input: report a sequence left unfinished, appending
+     * the replacement character to out
+     * @return false if the input ended inside a sequence and policy is
+     * cvt_stop*/
+    bool finish(std::basic_string<Unit>& out)
+    {
+      Unit c;
+      Unit* to;
+      const result res = finish(&c, &c + 1, to);
+      if(to != &c)
+        out += c;
+      return res != std::codecvt_base::error;
+    }
+
+    /**@brief Is the decoder inside a sequence*/
+    bool pending() const
+    {
+      return state_.state != UTF8_ACCEPT;
+    }
+
+    /**@brief Errors met since construction or the last reset()*/
+    const cvt_status& status() const
+    {
+      return status_;
+    }
+
+    /**@brief Forget the pending sequence and the error report*/
+    void reset()
+    {
+      state_ = utf8_state();
+      status_ = cvt_status();
+    }
+
+  private:
+    utf8_state state_;
+    cvt_status status_;
+};
+
 #endif // __MBWCVT_HPP__
@@ -0,0 +1,120 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Lookup table of single-byte codepage facets.
+ *
+ * This file is a part of hoxnox's facets project*/
+
+#ifndef __SBCS_TABLE_HPP__
+#define __SBCS_TABLE_HPP__
+
+#include <algorithm>
+#include <vector>
+
+/**@brief Characters first..last, encoded as c - delta*/
+struct sbcs_run
+{
+  long first;
+  long last;
+  long delta;
+};
+
+/**@brief UNICODE to byte table of a single-byte codepage
+ *
+ * Two levels: the high byte of a BMP character selects a 256-byte page,
+ * the low byte - the entry in it. Characters of unused pages share the
+ * empty page 0, so a codepage takes a few kilobytes and a lookup is two
+ * indexed loads. Unmapped characters give 0.
+ *
+ * Besides, the table keeps the two longest runs of consecutive characters
+ * on consecutive bytes (the Cyrillic alphabet in most codepages), so
+ * block encoders handle them with arithmetic and use the lookup for the
+ * rest only.*/
+class sbcs_out_table
+{
+  public:
+
+    enum { max_runs = 2, min_run = 16 };
+
+    sbcs_out_table()
+      : pages_(256, 0)
+    {
+      std::fill(index_, index_ + 256, 0);
+      clear_runs();
+    }
+
+    /**@brief Table inverting upper, the UNICODE characters of bytes
+     * 0x80..0xFF (0 for unmapped ones)*/
+    explicit sbcs_out_table(const wchar_t* upper)
+      : pages_(256, 0)
+    {
+      std::fill(index_, index_ + 256, 0);
+      for(int b = 0x80; b <= 0xFF; ++b)
+        if(upper[b - 0x80] != 0 && find(upper[b - 0x80]) == 0)
+          (*this)[upper[b - 0x80]] = static_cast<unsigned char>(b);
+      clear_runs();
+      for(int b = 0x80, n = 1; b <= 0xFF; b += n)
+      {
+        const long c = static_cast<long>(upper[b - 0x80]);
+        for(n = 1; b + n <= 0xFF; ++n)
+          if(static_cast<long>(upper[b + n - 0x80]) != c + n
+             || find(upper[b + n - 0x80]) != b + n)
+            break;
+        // 16-bit lanes of the block encoders compare signed
+        if(c == 0 || find(upper[b - 0x80]) != b || c + n > 0x7FFF
+           || n < min_run)
+          continue;
+        const sbcs_run run = { c, c + n - 1, c - b };
+        if(n > runs_[0].last - runs_[0].first + 1)
+        {
+          runs_[1] = runs_[0];
+          runs_[0] = run;
+        }
+        else if(n > runs_[1].last - runs_[1].first + 1)
+          runs_[1] = run;
+      }
+    }
+
+    /**@brief Entry of a character in U+0080..U+FFFF, allocating its
+     * page*/
+    unsigned char& operator[](wchar_t c)
+    {
+      unsigned char& page = index_[(c >> 8) & 0xFF];
+      if(page == 0)
+      {
+        page = static_cast<unsigned char>(pages_.size() / 256);
+        pages_.resize(pages_.size() + 256, 0);
+      }
+      return pages_[page * 256 + (c & 0xFF)];
+    }
+
+    /**@brief Byte of c, 0 if c is not in the codepage*/
+    unsigned char find(wchar_t c) const
+    {
+      const unsigned long u = static_cast<unsigned long>(c);
+      if(u > 0xFFFF)
+        return 0;
+      return pages_[index_[u >> 8] * 256 + (u & 0xFF)];
+    }
+
+    /**@brief Runs of consecutive characters, longest first. Unused ones
+     * are empty (first > last)*/
+    const sbcs_run* runs() const
+    {
+      return runs_;
+    }
+
+  private:
+
+    void clear_runs()
+    {
+      const sbcs_run none = { 1, 0, 0 };
+      std::fill(runs_, runs_ + max_runs, none);
+    }
+
+    unsigned char index_[256];
+    std::vector<unsigned char> pages_;
+    sbcs_run runs_[max_runs];
+};
+
+#endif // __SBCS_TABLE_HPP__
@@ -0,0 +1,240 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Direct conversion between single-byte codepages and UTF-8.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * Text is converted byte to byte, without a wide character string in
+ * between. Codepages are the table classes of the codecvt facets
+ * (sbcs_cp1251, sbcs_cp866, sbcs_koi8r, ...):
+ * @code
+ *  const char* next_in;
+ *  char* next_out;
+ *  sbcs_transcode<sbcs_cp866, sbcs_cp1251>(in, in_end, next_in,
+ *                                          out, out_end, next_out);
+ *  sbcs_to_utf8<sbcs_koi8r>(in, in_end, next_in, out, out_end, next_out);
+ * @endcode
+ * The functions work like std::codecvt::in() and out(): conversion stops
+ * with partial when the output is full and with error before a character
+ * the target can't represent, from_next and to_next receive the
+ * positions where it stopped. ASCII runs are copied by blocks.*/
+
+#ifndef __TRANSCODE_HPP__
+#define __TRANSCODE_HPP__
+
+#include <cstring>
+#include <locale>
+
+#include <codecvt/codecvt_sbcs.hpp>
+#include <codecvt/mbwcvt.hpp>
+#include <simd/utf8_simd.hpp>
+
+/**@brief Byte to byte table from codepage From to codepage To*/
+template <class From, class To>
+struct sbcs_byte_table
+{
+  unsigned char bytes[256]; // 0 for bytes missing in To, except 0 itself
+
+  sbcs_byte_table()
+  {
+    const wchar_t* upper = From::upper();
+    const sbcs_out_table& out = sbcs_codec<To>::out_table();
+    for(int b = 0; b <= 0x7F; ++b)
+      bytes[b] = static_cast<unsigned char>(b);
+    for(int b = 0x80; b <= 0xFF; ++b)
+      bytes[b] = upper[b - 0x80] == 0 ? 0 : out.find(upper[b - 0x80]);
+  }
+
+  /**@brief Table built on the first call*/
+  static const sbcs_byte_table& get()
+  {
+    static const sbcs_byte_table tab;
+    return tab;
+  }
+};
+
+/**@brief UTF-8 sequences of the bytes 0x80..0xFF of codepage From*/
+template <class From>
+struct sbcs_utf8_table
+{
+  char seq[128][4]; // bytes of the sequence, its length in seq[][3]
+
+  sbcs_utf8_table()
+  {
+    const wchar_t* upper = From::upper();
+    for(int b = 0; b < 128; ++b)
+    {
+      // codepage characters are in the BMP, 3 bytes at most
+      char* end = seq[b];
+      if(upper[b] != 0)
+        wcstombs(upper + b, upper + b + 1, seq[b], end);
+      seq[b][3] = static_cast<char>(end - seq[b]);
+    }
+  }
+
+  /**@brief Table built on the first call*/
+  static const sbcs_utf8_table& get()
+  {
+    static const sbcs_utf8_table tab;
+    return tab;
+  }
+};
+
+/**@brief Copy the ASCII run at the start of [i, e) to o, as much of it as
+ * fits into [o, o_end)*/
+inline void transcode_ascii(const char* &i, const char* e,
+                            char* &o, char* o_end)
+{
+  const size_t room = static_cast<size_t>(o_end - o);
+  const size_t n = utf8_ascii_length(
+      i, static_cast<size_t>(e - i) > room ? i + room : e);
+  std::memcpy(o, i, n);
+  i += n;
+  o += n;
+}
+
+/**@brief Translate text in codepage From into codepage To
+ * @return std::codecvt_base::ok when the whole input is converted,
+ * partial when the output is full, error when a character is missing in
+ * To (from_next points to it)*/
+template <class From, class To>
+std::codecvt_base::result sbcs_transcode(const char* from,
+                                         const char* from_end,
+                                         const char* &from_next,
+                                         char* to,
+                                         char* to_end,
+                                         char* &to_next)
+{
+  const unsigned char* bytes = sbcs_byte_table<From, To>::get().bytes;
+  std::codecvt_base::result res = std::codecvt_base::ok;
+  while(from != from_end)
+  {
+    if(to == to_end)
+    {
+      res = std::codecvt_base::partial;
+      break;
+    }
+    const unsigned char c = static_cast<unsigned char>(*from);
+    if(c <= 0x7F)
+    {
+      transcode_ascii(from, from_end, to, to_end);
+      continue;
+    }
+    if(bytes[c] == 0)
+    {
+      res = std::codecvt_base::error;
+      break;
+    }
+    *to++ = static_cast<char>(bytes[c]);
+    ++from;
+  }
+  from_next = from;
+  to_next = to;
+  return res;
+}
+
+/**@brief Translate text in codepage From into UTF-8
+ * @return std::codecvt_base::ok when the whole input is converted,
+ * partial when the output is full, error on a byte unmapped in From
+ * (from_next points to it)*/
+template <class From>
+std::codecvt_base::result sbcs_to_utf8(const char* from,
+                                       const char* from_end,
+                                       const char* &from_next,
+                                       char* to,
+                                       char* to_end,
+                                       char* &to_next)
+{
+  const sbcs_utf8_table<From>& tab = sbcs_utf8_table<From>::get();
+  std::codecvt_base::result res = std::codecvt_base::ok;
+  while(from != from_end)
+  {
+    const unsigned char c = static_cast<unsigned char>(*from);
+    if(c <= 0x7F)
+    {
+      if(to == to_end)
+      {
+        res = std::codecvt_base::partial;
+        break;
+      }
+      transcode_ascii(from, from_end, to, to_end);
+      continue;
+    }
+    const char* seq = tab.seq[c - 0x80];
+    const int n = seq[3];
+    if(n == 0)
+    {
+      res = std::codecvt_base::error;
+      break;
+    }
+    if(to_end - to < n)
+    {
+      res = std::codecvt_base::partial;
+      break;
+    }
+    for(int k = 0; k < n; ++k)
+      *to++ = seq[k];
+    ++from;
+  }
+  from_next = from;
+  to_next = to;
+  return res;
+}
+
+/**@brief Translate UTF-8 text into codepage To
+ * @return std::codecvt_base::ok when the whole input is converted,
+ * partial when the output is full or the input ends inside a sequence,
+ * error on an invalid sequence or a character missing in To (from_next
+ * points to the start of the sequence)
+ *
+ * A sequence cut by from_end is left unconsumed, so text can be
+ * converted in chunks.*/
+template <class To>
+std::codecvt_base::result utf8_to_sbcs(const char* from,
+                                       const char* from_end,
+                                       const char* &from_next,
+                                       char* to,
+                                       char* to_end,
+                                       char* &to_next)
+{
+  const sbcs_out_table& out = sbcs_codec<To>::out_table();
+  std::codecvt_base::result res = std::codecvt_base::ok;
+  while(from != from_end)
+  {
+    if(to == to_end)
+    {
+      res = std::codecvt_base::partial;
+      break;
+    }
+    if(static_cast<unsigned char>(*from) <= 0x7F)
+    {
+      transcode_ascii(from, from_end, to, to_end);
+      continue;
+    }
+    const char* i = from;
+    unsigned state = UTF8_ACCEPT, cp = 0;
+    do
+      utf8_decode(state, cp, static_cast<unsigned char>(*i++));
+    while(i != from_end && state != UTF8_ACCEPT && state != UTF8_REJECT);
+    if(state != UTF8_ACCEPT && state != UTF8_REJECT)
+    {
+      res = std::codecvt_base::partial;
+      break;
+    }
+    const unsigned char b = state == UTF8_ACCEPT && cp <= 0xFFFF
+                          ? out.find(static_cast<wchar_t>(cp)) : 0;
+    if(b == 0)
+    {
+      res = std::codecvt_base::error;
+      break;
+    }
+    *to++ = static_cast<char>(b);
+    from = i;
+  }
+  from_next = from;
+  to_next = to;
+  return res;
+}
+
+#endif // __TRANSCODE_HPP__
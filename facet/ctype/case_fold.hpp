@@ -0,0 +1,269 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Case-insensitive comparison and hashing of UNICODE strings.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * Strings are compared by their full case folding (CaseFolding.txt
+ * statuses C and F): "Straße" equals "STRASSE". Characters are folded on
+ * the fly and nothing is allocated. Blocks of ASCII and basic Cyrillic
+ * characters are compared with the SIMD kernels of case_simd.hpp, the
+ * others through the tables:
+ * @code
+ *  if(case_fold_equal(a, a + n, b, b + m))
+ *    ...
+ *  const size_t h = case_fold_hash(a, a + n); // equal for equal strings
+ *  const wchar_t* found = case_fold_find(text, text_end, word, word_end);
+ * @endcode
+ * 16-bit strings are read as UTF-16, unpaired surrogates stand for
+ * themselves.*/
+
+#ifndef __CASE_FOLD_HPP__
+#define __CASE_FOLD_HPP__
+
+#include <algorithm>
+#include <cstddef>
+
+#include <ctype/unicode_tables.hpp>
+#include <simd/case_simd.hpp>
+
+/**@brief Reader of the case folding of [b, e), one code point at a time*/
+template <class Unit>
+class case_fold_reader
+{
+  public:
+    case_fold_reader(const Unit* b, const Unit* e)
+      : i(b),
+        end(e),
+        pos(0),
+        count(0)
+    {
+    }
+
+    /**@brief Is the next code unit of the source readable as is: no
+     * folded characters are pending*/
+    bool aligned() const
+    {
+      return pos == count;
+    }
+
+    /**@brief Next code unit of the source, only when aligned()*/
+    const Unit* source() const
+    {
+      return i;
+    }
+
+    /**@brief Continue from code unit p of the source, only when
+     * aligned()*/
+    void seek(const Unit* p)
+    {
+      i = p;
+    }
+
+    /**@brief Next folded code point
+     * @return false at the end*/
+    bool next(unsigned long& c)
+    {
+      if(pos == count)
+      {
+        if(i == end)
+          return false;
+        const unsigned long u = read();
+        folded[0] = case_fold_basic(u);
+        count = folded[0] != case_fold_other ? 1 : unicode_fold(u, folded);
+        pos = 0;
+      }
+      c = folded[pos++];
+      return true;
+    }
+
+  private:
+    /**@brief Code point at i, moving past it*/
+    unsigned long read()
+    {
+      const unsigned long c = static_cast<unsigned long>(*i++);
+      if(sizeof(Unit) == 2 && (c & 0xFC00) == 0xD800 && i != end
+         && (static_cast<unsigned long>(*i) & 0xFC00) == 0xDC00)
+        return 0x10000 + ((c - 0xD800) << 10)
+                       + (static_cast<unsigned long>(*i++) - 0xDC00);
+      return c;
+    }
+
+    const Unit* i;
+    const Unit* end;
+    unsigned long folded[3];
+    int pos;
+    int count;
+};
+
+/**@brief Compare case foldings of [b1, e1) and [b2, e2) by code points
+ * @return negative, zero or positive, like std::wstring::compare()*/
+template <class Unit>
+int case_fold_compare(const Unit* b1, const Unit* e1,
+                      const Unit* b2, const Unit* e2)
+{
+  case_fold_reader<Unit> r1(b1, e1), r2(b2, e2);
+  for(;;)
+  {
+    if(r1.aligned() && r2.aligned())
+    {
+      // blocks of basic characters are compared by case_fold_prefix(),
+      // the block it stops at here: equal characters fold equally,
+      // basic ones are folded in place
+      const Unit *i1 = r1.source(), *i2 = r2.source();
+      bool basic = true;
+      while(basic && i1 != e1 && i2 != e2)
+      {
+        const size_t n = std::min(static_cast<size_t>(e1 - i1),
+                                  static_cast<size_t>(e2 - i2));
+        const size_t k = case_fold_prefix(i1, i2, n);
+        i1 += k;
+        i2 += k;
+        for(const Unit* stop = i1 + std::min<size_t>(n - k, 32);
+            i1 != stop; ++i1, ++i2)
+        {
+          const unsigned long c1 = static_cast<unsigned long>(*i1);
+          const unsigned long c2 = static_cast<unsigned long>(*i2);
+          if(c1 == c2 && (sizeof(Unit) != 2 || (c1 & 0xF800) != 0xD800))
+            continue;
+          const unsigned long f1 = case_fold_basic(c1);
+          const unsigned long f2 = case_fold_basic(c2);
+          if(f1 == case_fold_other || f2 == case_fold_other)
+          {
+            basic = false;
+            break;
+          }
+          if(f1 != f2)
+            return f1 < f2 ? -1 : 1;
+        }
+      }
+      r1.seek(i1);
+      r2.seek(i2);
+    }
+    unsigned long c1, c2;
+    const bool more1 = r1.next(c1), more2 = r2.next(c2);
+    if(!more1 || !more2)
+      return more1 ? 1 : more2 ? -1 : 0;
+    if(c1 != c2)
+      return c1 < c2 ? -1 : 1;
+  }
+}
+
+/**@brief Are case foldings of [b1, e1) and [b2, e2) equal*/
+template <class Unit>
+bool case_fold_equal(const Unit* b1, const Unit* e1,
+                     const Unit* b2, const Unit* e2)
+{
+  return case_fold_compare(b1, e1, b2, e2) == 0;
+}
+
+/**@brief Hash of the case folding of [b, e), FNV-1a over code points*/
+template <class Unit>
+size_t case_fold_hash(const Unit* b, const Unit* e)
+{
+  case_fold_reader<Unit> r(b, e);
+  size_t h = 2166136261u;
+  unsigned long c;
+  while(r.next(c))
+    h = (h ^ c) * 16777619u;
+  return h;
+}
+
+/**@brief Simple case folding of code unit c*/
+inline unsigned long case_fold_unit(unsigned long c)
+{
+  const unsigned long f = case_fold_basic(c);
+  return f != case_fold_other ? f : unicode_simple_fold(c);
+}
+
+/**@brief Do m units at h and n match by simple case folding*/
+template <class Unit>
+bool case_fold_match(const Unit* h, const Unit* n, size_t m)
+{
+  for(size_t k = 0; k < m; ++k)
+    if(h[k] != n[k]
+       && case_fold_unit(static_cast<unsigned long>(h[k]))
+          != case_fold_unit(static_cast<unsigned long>(n[k])))
+      return false;
+  return true;
+}
+
+/**@brief Scalar version of case_fold_find(), Horspool's algorithm with
+ * the shift table indexed by the low byte of folded units*/
+template <class Unit>
+const Unit* case_fold_find_scalar(const Unit* hb, const Unit* he,
+                                  const Unit* nb, const Unit* ne)
+{
+  const size_t m = static_cast<size_t>(ne - nb);
+  size_t shift[256];
+  for(int k = 0; k < 256; ++k)
+    shift[k] = m;
+  for(size_t k = 0; k + 1 < m; ++k)
+    shift[case_fold_unit(static_cast<unsigned long>(nb[k])) & 0xFF] =
+        m - 1 - k;
+  const unsigned long last = case_fold_unit(
+      static_cast<unsigned long>(ne[-1]));
+  for(const Unit* i = hb; static_cast<size_t>(he - i) >= m;)
+  {
+    const unsigned long c = case_fold_unit(
+        static_cast<unsigned long>(i[m - 1]));
+    if(c == last && case_fold_match(i, nb, m - 1))
+      return i;
+    i += shift[c & 0xFF];
+  }
+  return he;
+}
+
+/**@brief SIMD version of case_fold_find(): positions are filtered by the
+ * first and the last character with case_fold_filter()*/
+template <class Unit>
+const Unit* case_fold_find_filtered(const Unit* hb, const Unit* he,
+                                    const Unit* nb, const Unit* ne)
+{
+  const size_t m = static_cast<size_t>(ne - nb);
+  const size_t n = static_cast<size_t>(he - hb) - m + 1;
+  const unsigned long first = case_fold_unit(
+      static_cast<unsigned long>(nb[0]));
+  const unsigned long last = case_fold_unit(
+      static_cast<unsigned long>(ne[-1]));
+  size_t k = 0;
+  while(k < n)
+  {
+    unsigned hits = 0;
+    k += case_fold_filter(hb + k, n - k, m, first, last, hits);
+    // the search goes on after the last candidate of the block
+    for(; hits != 0; hits >>= 1, ++k)
+      if((hits & 1) && case_fold_match(hb + k, nb, m))
+        return hb + k;
+  }
+  return he;
+}
+
+/**@brief Find [nb, ne) in [hb, he) ignoring case
+ * @return start of the first occurrence, he if there is none
+ *
+ * Characters are compared by simple case folding, one code unit for one:
+ * unlike case_fold_compare() "ß" does not match "ss". Nothing is
+ * allocated.*/
+template <class Unit>
+const Unit* case_fold_find(const Unit* hb, const Unit* he,
+                           const Unit* nb, const Unit* ne)
+{
+  if(nb == ne)
+    return hb;
+  if(he - hb < ne - nb)
+    return he;
+  typedef const Unit* (*kernel)(const Unit*, const Unit*, const Unit*,
+                                const Unit*);
+  static const kernel kernels[simd_levels] =
+  {
+    &case_fold_find_scalar<Unit>,
+    &case_fold_find_filtered<Unit>,
+    &case_fold_find_filtered<Unit>,
+    &case_fold_find_filtered<Unit>
+  };
+  return kernels[simd_active()](hb, he, nb, ne);
+}
+
+#endif // __CASE_FOLD_HPP__
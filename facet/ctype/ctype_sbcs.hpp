@@ -0,0 +1,129 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief ctype facet of single-byte codepages.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * The facet is the table-based std::ctype<char>: classification is one
+ * load from a 256-entry mask table, case mapping one load from the upper
+ * or lower case table. Tables are built once per codepage from its table
+ * class (see codecvt_sbcs.hpp) and the UNICODE properties of the
+ * characters, so bytes are classified and case-mapped in place, without
+ * conversion into UNICODE:
+ * @code
+ *  const std::locale loc(std::locale::classic(), new ctype_cp1251<>);
+ *  std::use_facet<std::ctype<char> >(loc).toupper(buf, buf + size);
+ * @endcode
+ * Unmapped bytes have no class and keep their case. A letter whose pair
+ * is missing in the codepage keeps its case too.*/
+
+#ifndef __CTYPE_SBCS_HPP__
+#define __CTYPE_SBCS_HPP__
+
+#include <locale>
+
+#include <codecvt/codecvt_sbcs.hpp>
+#include <ctype/ctype_unicode.hpp>
+#include <ctype/unicode_tables.hpp>
+
+/**@brief Classification and case mapping tables of codepage Table*/
+template <class Table>
+struct sbcs_ctype_tables
+{
+  std::ctype_base::mask masks[256];
+  unsigned char upper[256];
+  unsigned char lower[256];
+
+  sbcs_ctype_tables()
+  {
+    // ASCII is classified as by the classic facet, to the bit
+    const std::ctype_base::mask* classic =
+        std::ctype<char>::classic_table();
+    const wchar_t* chars = Table::upper();
+    const sbcs_out_table& out = sbcs_codec<Table>::out_table();
+    for(int b = 0; b < 256; ++b)
+    {
+      const unsigned long c = b <= 0x7F
+                            ? static_cast<unsigned long>(b)
+                            : static_cast<unsigned long>(chars[b - 0x80]);
+      masks[b] = b <= 0x7F ? classic[b]
+               : c != 0 ? unicode_ctype_mask(unicode_props(c)) : 0;
+      upper[b] = byte_of(out, unicode_toupper(c), b);
+      lower[b] = byte_of(out, unicode_tolower(c), b);
+    }
+  }
+
+  /**@brief Tables built on the first call*/
+  static const sbcs_ctype_tables& get()
+  {
+    static const sbcs_ctype_tables tab;
+    return tab;
+  }
+
+  private:
+    /**@brief Byte of c, def if it is missing in the codepage (unmapped
+     * bytes stand for character 0)*/
+    static unsigned char byte_of(const sbcs_out_table& out, unsigned long c,
+                                 int def)
+    {
+      unsigned char b = 0;
+      if(c != 0 && c <= 0x7F)
+        b = static_cast<unsigned char>(c);
+      else if(c > 0x7F && c <= 0xFFFF)
+        b = out.find(static_cast<wchar_t>(c));
+      return b != 0 ? b : static_cast<unsigned char>(def);
+    }
+};
+
+/**@brief ctype<char> facet of the single-byte codepage described by
+ * Table*/
+template <class Table>
+class ctype_sbcs : public std::ctype<char>
+{
+  public:
+    typedef sbcs_ctype_tables<Table> tables;
+
+    explicit ctype_sbcs(size_t r = 0)
+      : std::ctype<char>(tables::get().masks, false, r)
+    {
+    }
+
+    ~ctype_sbcs()
+    {}
+
+  protected:
+    virtual char do_toupper(char c) const
+    {
+      return static_cast<char>(
+          tables::get().upper[static_cast<unsigned char>(c)]);
+    }
+
+    virtual const char* do_toupper(char* b, const char* e) const
+    {
+      const unsigned char* upper = tables::get().upper;
+      for(; b != e; ++b)
+        *b = static_cast<char>(upper[static_cast<unsigned char>(*b)]);
+      return e;
+    }
+
+    virtual char do_tolower(char c) const
+    {
+      return static_cast<char>(
+          tables::get().lower[static_cast<unsigned char>(c)]);
+    }
+
+    virtual const char* do_tolower(char* b, const char* e) const
+    {
+      const unsigned char* lower = tables::get().lower;
+      for(; b != e; ++b)
+        *b = static_cast<char>(lower[static_cast<unsigned char>(*b)]);
+      return e;
+    }
+
+  private:
+    ctype_sbcs(const ctype_sbcs&);
+    void operator=(const ctype_sbcs&);
+};
+
+#endif // __CTYPE_SBCS_HPP__
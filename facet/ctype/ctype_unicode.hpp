@@ -2,12 +2,38 @@
 #define __CTYPE_UNICODE_HPP__
 
 #include <locale>
-#include <map>
+
+#include <ctype/unicode_tables.hpp>
+#include <simd/case_simd.hpp>
 
 using namespace std;
 
-/**@brief ctype facet modification for unicode cyrillic (basic russian
- * alphabet and cyrillic extensions) symbols
+/**@brief std::ctype mask of unicode_property flags*/
+inline ctype_base::mask unicode_ctype_mask(unsigned props)
+{
+  ctype_base::mask m = 0;
+  if(props & unicode_upper)  m |= ctype_base::upper;
+  if(props & unicode_lower)  m |= ctype_base::lower;
+  if(props & unicode_alpha)  m |= ctype_base::alpha;
+  if(props & unicode_digit)  m |= ctype_base::digit;
+  if(props & unicode_xdigit) m |= ctype_base::xdigit;
+  if(props & unicode_space)  m |= ctype_base::space;
+  if(props & unicode_print)  m |= ctype_base::print;
+  if(props & unicode_cntrl)  m |= ctype_base::cntrl;
+  if(props & unicode_punct)  m |= ctype_base::punct;
+#if __cplusplus >= 201103L
+  if(props & unicode_blank)  m |= ctype_base::blank;
+#endif
+  // graph is alpha, digit or punct
+  return m;
+}
+
+/**@brief ctype facet modification for unicode symbols
+ *
+ * Classification and case mapping of the whole UNICODE range come from
+ * the generated tables of unicode_tables.hpp: a lookup is a few indexed
+ * loads, without allocation or searching. Classes are translated into
+ * ctype masks once, in the constructor.
  *
  * See ctype facet decl*/
 class ctype_unicode : public ctype<wchar_t>
@@ -25,15 +51,10 @@ class ctype_unicode : public ctype<wchar_t>
     explicit ctype_unicode(size_t r = 0)
       : std::ctype<wchar_t>(r)
     {
-      // initializing masks map
-      for(wchar_t i = 0x400; i <= 0x40F; i++)
-        masks[i] = upper | alpha | print;
-      for(wchar_t i = 0x410; i <= 0x42F; i++)
-        masks[i] = upper | alpha | print;
-      for(wchar_t i = 0x430; i <= 0x44F; i++)
-        masks[i] = lower | alpha | print;
-      for(wchar_t i = 0x450; i <= 0x45F; i++)
-        masks[i] = lower | alpha | print;
+      // initializing masks of the classes
+      const unicode_class* classes = unicode_classes();
+      for(int i = 0; i < unicode_class_count; ++i)
+        masks[i] = unicode_ctype_mask(classes[i].props);
     }
 
     ~ctype_unicode()
@@ -42,11 +63,7 @@ class ctype_unicode : public ctype<wchar_t>
   protected:
     virtual bool do_is(mask m, wchar_t c) const
     {
-      std::map<mask, wchar_t>::const_iterator msk = masks.find(c);
-      if(msk != masks.end())
-        return (msk->second & m) != 0;
-      else
-        return ctype<wchar_t>::do_is(m,c);
+      return (masks[unicode_class_of(code(c))] & m) != 0;
     };
 
     virtual const wchar_t* do_is(const wchar_t* b,
@@ -54,16 +71,8 @@ class ctype_unicode : public ctype<wchar_t>
                                  mask* v)
     const
     {
-      while(b != e)
-      {
-        std::map<mask, wchar_t>::const_iterator msk = masks.find(*b);
-        if(msk != masks.end())
-          *v = msk->first;
-        else
-          ctype<wchar_t>::do_is(b, b+1, v);
-        ++b;
-        ++v;
-      }
+      for(; b != e; ++b, ++v)
+        *v = masks[unicode_class_of(code(*b))];
       return b;
     }
 
@@ -87,59 +96,23 @@ class ctype_unicode : public ctype<wchar_t>
 
     virtual wchar_t do_toupper(wchar_t c) const
     {
-      std::map<mask, wchar_t>::const_iterator msk = masks.find(c);
-      if( msk != masks.end() )
-      {
-        if( this->do_is(lower,c) )
-        {
-          // cyrillic extensions
-          if(0x450 <= c && c <= 0x45F)
-            return c - 0x50;
-          // basic russian alphabet
-          else if(0x430 <= c && c <= 0x44F)
-            return c - 0x20;
-        }
-        else
-        {
-          return c;
-        }
-      }
-      return ctype<wchar_t>::do_toupper(c);
+      return static_cast<wchar_t>(unicode_toupper(code(c)));
     }
 
     virtual const wchar_t* do_toupper(wchar_t* b, const wchar_t* e) const
     {
-      for(; b!=e; ++b)
-        *b = do_toupper(*b);
+      case_map(b, e, b, case_to_upper);
       return e;
     }
 
     virtual wchar_t do_tolower(wchar_t c) const
     {
-      std::map<mask, wchar_t>::const_iterator msk = masks.find(c);
-      if( msk != masks.end() )
-      {
-        if( this->do_is(upper,c) )
-        {
-          // cyrillic extensions
-          if(0x400 <= c && c <= 0x40F)
-            return c + 0x50;
-          // basic russian alphabet
-          else if(0x410 <= c && c <= 0x42F)
-            return c + 0x20;
-        }
-        else
-        {
-          return c;
-        }
-      }
-      return ctype<wchar_t>::do_tolower(c);
+      return static_cast<wchar_t>(unicode_tolower(code(c)));
     }
 
     virtual const wchar_t* do_tolower(wchar_t* b, const wchar_t* e) const
     {
-      for(; b!=e; ++b)
-        *b = do_tolower(*b);
+      case_map(b, e, b, case_to_lower);
       return e;
     }
 
@@ -187,7 +160,14 @@ class ctype_unicode : public ctype<wchar_t>
   private:
     ctype_unicode(const ctype_unicode&);
     void operator=(const ctype_unicode&);
-    std::map<mask, wchar_t> masks;
+
+    /**@brief Code point of c, negative values are out of UNICODE*/
+    static unsigned long code(wchar_t c)
+    {
+      return static_cast<unsigned long>(c);
+    }
+
+    mask masks[unicode_class_count];
 };
 
 #endif // __CTYPE_UNICODE_HPP__
@@ -0,0 +1,182 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief UNICODE character properties, simple case mapping and case
+ * folding.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * Characters with equal properties and case mapping deltas share a
+ * class. Classes are looked up in two stages: the high bits of a code
+ * point select a 256-entry block through the page index, the low byte
+ * selects the class in the block. Equal blocks are stored once, so the
+ * whole range U+0000..U+10FFFF takes about 40 kilobytes. The hundred or so
+ * characters folding to several ones are kept in a sorted list. The tables
+ * are generated by tools/unicode_tables.py from UnicodeData.txt and
+ * CaseFolding.txt.*/
+
+#ifndef __UNICODE_TABLES_HPP__
+#define __UNICODE_TABLES_HPP__
+
+/**@brief Character properties, POSIX classes over the general
+ * categories, see tools/unicode_tables.py*/
+enum unicode_property
+{
+  unicode_upper  = 0x001,
+  unicode_lower  = 0x002,
+  unicode_alpha  = 0x004,
+  unicode_digit  = 0x008,
+  unicode_xdigit = 0x010,
+  unicode_space  = 0x020,
+  unicode_print  = 0x040,
+  unicode_cntrl  = 0x080,
+  unicode_punct  = 0x100,
+  unicode_graph  = 0x200,
+  unicode_blank  = 0x400,
+  unicode_full_fold = 0x800 // folds to several characters, see unicode_fold
+};
+
+/**@brief Properties and simple case mapping of a character class*/
+struct unicode_class
+{
+  unsigned short props; // unicode_property flags
+  long upper;           // toupper(c) - c
+  long lower;           // tolower(c) - c
+  long fold;            // fold(c) - c, 0 with unicode_full_fold
+};
+
+/**@brief Number of classes*/
+enum
+{
+  unicode_class_count = 0
+#define UNICODE_CLASS(props, upper, lower, fold) + 1
+#include <ctype/unicode/classes.def>
+#undef UNICODE_CLASS
+};
+
+/**@brief Classes, class 0 is unassigned code points*/
+inline const unicode_class* unicode_classes()
+{
+  static const unicode_class tab[unicode_class_count] =
+  {
+#define UNICODE_CLASS(props, upper, lower, fold) \
+  { props, upper, lower, fold },
+#include <ctype/unicode/classes.def>
+#undef UNICODE_CLASS
+  };
+  return tab;
+}
+
+/**@brief Block of each 256-character page, U+0000..U+10FFFF*/
+inline const unsigned char* unicode_pages()
+{
+  static const unsigned char tab[0x1100] =
+  {
+#include <ctype/unicode/pages.def>
+  };
+  return tab;
+}
+
+/**@brief Blocks of 256 class numbers*/
+inline const unsigned char* unicode_blocks()
+{
+  static const unsigned char tab[] =
+  {
+#include <ctype/unicode/blocks.def>
+  };
+  return tab;
+}
+
+/**@brief Class number of c, 0 for values out of UNICODE*/
+inline unsigned unicode_class_of(unsigned long c)
+{
+  if(c > 0x10FFFF)
+    return 0;
+  return unicode_blocks()[unicode_pages()[c >> 8] * 256 + (c & 0xFF)];
+}
+
+/**@brief unicode_property flags of c*/
+inline unsigned unicode_props(unsigned long c)
+{
+  return unicode_classes()[unicode_class_of(c)].props;
+}
+
+/**@brief Simple uppercase mapping of c*/
+inline unsigned long unicode_toupper(unsigned long c)
+{
+  return c + unicode_classes()[unicode_class_of(c)].upper;
+}
+
+/**@brief Simple lowercase mapping of c*/
+inline unsigned long unicode_tolower(unsigned long c)
+{
+  return c + unicode_classes()[unicode_class_of(c)].lower;
+}
+
+/**@brief Simple case folding of c: one character for one, characters
+ * with full folding to several ones are mapped to lower case*/
+inline unsigned long unicode_simple_fold(unsigned long c)
+{
+  const unicode_class& cls = unicode_classes()[unicode_class_of(c)];
+  return c + (cls.props & unicode_full_fold ? cls.lower : cls.fold);
+}
+
+/**@brief Character folding to several ones*/
+struct unicode_full_folding
+{
+  unsigned long c;
+  unsigned long fold[3]; // padded with 0
+};
+
+/**@brief Number of characters folding to several ones*/
+enum
+{
+  unicode_full_folding_count = 0
+#define UNICODE_FOLD(c, f1, f2, f3) + 1
+#include <ctype/unicode/folds.def>
+#undef UNICODE_FOLD
+};
+
+/**@brief Characters folding to several ones, sorted*/
+inline const unicode_full_folding* unicode_full_foldings()
+{
+  static const unicode_full_folding tab[unicode_full_folding_count] =
+  {
+#define UNICODE_FOLD(c, f1, f2, f3) { c, { f1, f2, f3 } },
+#include <ctype/unicode/folds.def>
+#undef UNICODE_FOLD
+  };
+  return tab;
+}
+
+/**@brief Full case folding of c
+ * @param out receives the folded characters, 3 at most
+ * @return number of characters written*/
+inline int unicode_fold(unsigned long c, unsigned long* out)
+{
+  const unicode_class& cls = unicode_classes()[unicode_class_of(c)];
+  if(!(cls.props & unicode_full_fold))
+  {
+    out[0] = c + cls.fold;
+    return 1;
+  }
+  const unicode_full_folding* tab = unicode_full_foldings();
+  int lo = 0, hi = unicode_full_folding_count - 1;
+  while(lo < hi)
+  {
+    const int mid = (lo + hi) / 2;
+    if(tab[mid].c < c)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  int n = 0;
+  while(n < 3 && tab[lo].fold[n] != 0)
+  {
+    out[n] = tab[lo].fold[n];
+    ++n;
+  }
+  return n;
+}
+
+#endif // __UNICODE_TABLES_HPP__
@@ -0,0 +1,590 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief SIMD kernels of bulk case mapping of UNICODE strings.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * Letters of ASCII and of the basic Cyrillic block (U+0400..U+045F) map
+ * to the other case with a constant delta over a few ranges. Kernels
+ * compare blocks of characters against the ranges and add the delta of
+ * the matching one. The other characters of a block are marked in a mask
+ * and mapped one by one with the tables of unicode_tables.hpp. The same
+ * mapping to lower case compares blocks of two strings ignoring case.
+ * Kernels are selected at run time by cpu_dispatch.hpp, the AVX-512 level
+ * uses the AVX2 kernel.*/
+
+#ifndef __CASE_SIMD_HPP__
+#define __CASE_SIMD_HPP__
+
+#include <cstddef>
+
+#include <ctype/unicode_tables.hpp>
+#include <simd/cpu_dispatch.hpp>
+
+/**@brief Direction of case mapping*/
+enum case_direction
+{
+  case_to_upper,
+  case_to_lower
+};
+
+/**@brief Characters first..last map to the other case by adding delta*/
+struct case_range
+{
+  long first;
+  long last;
+  long delta;
+};
+
+enum { case_ranges_count = 3 };
+
+/**@brief Ranges of ASCII and basic Cyrillic letters mapped in direction d
+ *
+ * The ranges lie in U+0000..U+007F and U+0400..U+045F, every character
+ * of these blocks outside of the ranges maps to itself.*/
+inline const case_range* case_ranges(case_direction d)
+{
+  static const case_range upper[case_ranges_count] =
+  {
+    { 0x0061, 0x007A, -0x20 }, // a..z
+    { 0x0430, 0x044F, -0x20 }, // U+0430..U+044F
+    { 0x0450, 0x045F, -0x50 }  // U+0450..U+045F
+  };
+  static const case_range lower[case_ranges_count] =
+  {
+    { 0x0041, 0x005A, 0x20 },  // A..Z
+    { 0x0410, 0x042F, 0x20 },  // U+0410..U+042F
+    { 0x0400, 0x040F, 0x50 }   // U+0400..U+040F
+  };
+  return d == case_to_upper ? upper : lower;
+}
+
+/**@brief Map character c in direction d*/
+template <class Unit>
+inline Unit case_map_char(Unit c, case_direction d)
+{
+  const unsigned long u = static_cast<unsigned long>(c);
+  return static_cast<Unit>(d == case_to_upper ? unicode_toupper(u)
+                                              : unicode_tolower(u));
+}
+
+/**@brief Map [b, e) in direction d into o, scalar version*/
+template <class Unit>
+inline void case_map_scalar(const Unit* b, const Unit* e, Unit* o,
+                            case_direction d)
+{
+  for(; b != e; ++b, ++o)
+    *o = case_map_char(*b, d);
+}
+
+enum { case_fold_other = 0x7FFFFFFF };
+
+/**@brief Folding of an ASCII or basic Cyrillic (U+0400..U+045F)
+ * character, its lower case, case_fold_other for the others*/
+inline unsigned long case_fold_basic(unsigned long c)
+{
+  if(c < 0x80)
+    return c - 0x41 < 26 ? c + 0x20 : c;
+  if(c - 0x400 < 0x60)
+    return c < 0x410 ? c + 0x50 : c < 0x430 ? c + 0x20 : c;
+  return case_fold_other;
+}
+
+/**@brief Scalar version of case_fold_filter()*/
+template <class Unit>
+inline size_t case_fold_filter_scalar(const Unit* b, size_t n, size_t m,
+                                      unsigned long first,
+                                      unsigned long last, unsigned& hits)
+{
+  // characters out of ASCII and basic Cyrillic may fold to anything
+  for(size_t k = 0; k < n; ++k)
+  {
+    const unsigned long f =
+        case_fold_basic(static_cast<unsigned long>(b[k]));
+    const unsigned long l =
+        case_fold_basic(static_cast<unsigned long>(b[k + m - 1]));
+    if((f == first || f == case_fold_other)
+       && (l == last || l == case_fold_other))
+    {
+      hits = 1;
+      return k;
+    }
+  }
+  return n;
+}
+
+#if defined(FACETS_SIMD_X86)
+/**@brief Map the characters of a block marked in miss, one bit per byte
+ * of the code unit*/
+template <class Unit>
+inline void case_simd_patch(const Unit* i, Unit* o, unsigned miss,
+                            case_direction d)
+{
+  const unsigned unit = (1u << sizeof(Unit)) - 1;
+  while(miss != 0)
+  {
+    const int k = __builtin_ctz(miss) / static_cast<int>(sizeof(Unit));
+    o[k] = case_map_char(i[k], d);
+    miss &= ~(unit << (k * sizeof(Unit)));
+  }
+}
+
+/**@brief SSE2 lane operations on code units of the given size*/
+template <size_t size>
+struct case_sse2;
+
+template <>
+struct case_sse2<2>
+{
+  static __m128i set1(long v)
+  {
+    return _mm_set1_epi16(static_cast<short>(v));
+  }
+  static __m128i cmpgt(__m128i a, __m128i b)
+  {
+    return _mm_cmpgt_epi16(a, b);
+  }
+  static __m128i add(__m128i a, __m128i b)
+  {
+    return _mm_add_epi16(a, b);
+  }
+};
+
+template <>
+struct case_sse2<4>
+{
+  static __m128i set1(long v)
+  {
+    return _mm_set1_epi32(static_cast<int>(v));
+  }
+  static __m128i cmpgt(__m128i a, __m128i b)
+  {
+    return _mm_cmpgt_epi32(a, b);
+  }
+  static __m128i add(__m128i a, __m128i b)
+  {
+    return _mm_add_epi32(a, b);
+  }
+};
+
+/**@brief Range constants of direction d in SSE2 registers*/
+template <class Unit>
+struct case_sse2_mapper
+{
+  typedef case_sse2<sizeof(Unit)> op;
+
+  __m128i above[case_ranges_count];
+  __m128i below[case_ranges_count];
+  __m128i delta[case_ranges_count];
+  __m128i ascii_above, ascii_below, cyr_above, cyr_below;
+
+  explicit case_sse2_mapper(case_direction d)
+  {
+    // 16-bit units above U+7FFF and negative 32-bit ones compare as
+    // negative and are in no range
+    const case_range* r = case_ranges(d);
+    for(int k = 0; k < case_ranges_count; ++k)
+    {
+      above[k] = op::set1(r[k].first - 1);
+      below[k] = op::set1(r[k].last + 1);
+      delta[k] = op::set1(r[k].delta);
+    }
+    ascii_above = op::set1(-1);
+    ascii_below = op::set1(0x80);
+    cyr_above = op::set1(0x3FF);
+    cyr_below = op::set1(0x460);
+  }
+
+  /**@brief Map ASCII and basic Cyrillic lanes of c, known receives
+   * them*/
+  __m128i map(__m128i c, __m128i& known) const
+  {
+    known = _mm_or_si128(
+        _mm_and_si128(op::cmpgt(c, ascii_above), op::cmpgt(ascii_below, c)),
+        _mm_and_si128(op::cmpgt(c, cyr_above), op::cmpgt(cyr_below, c)));
+    __m128i add = _mm_setzero_si128();
+    for(int k = 0; k < case_ranges_count; ++k)
+    {
+      const __m128i in = _mm_and_si128(op::cmpgt(c, above[k]),
+                                       op::cmpgt(below[k], c));
+      add = _mm_or_si128(add, _mm_and_si128(in, delta[k]));
+    }
+    return op::add(c, add);
+  }
+};
+
+/**@brief SSE2 version of case_map()*/
+template <class Unit>
+inline void case_map_sse2(const Unit* b, const Unit* e, Unit* o,
+                          case_direction d)
+{
+  enum { lanes = 16 / sizeof(Unit) };
+  const case_sse2_mapper<Unit> m(d);
+  const Unit* i = b;
+  for(; e - i >= lanes; i += lanes, o += lanes)
+  {
+    __m128i known;
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o), m.map(c, known));
+    const unsigned miss = ~static_cast<unsigned>(_mm_movemask_epi8(known))
+                        & 0xFFFF;
+    case_simd_patch(i, o, miss, d);
+  }
+  case_map_scalar(i, e, o, d);
+}
+
+/**@brief Load 8 code units to 16-bit lanes, saturating 32-bit ones*/
+template <class Unit>
+inline __m128i case_simd_load8(const Unit* p)
+{
+  const __m128i* q = reinterpret_cast<const __m128i*>(p);
+  if(sizeof(Unit) == 2)
+    return _mm_loadu_si128(q);
+  return _mm_packs_epi32(_mm_loadu_si128(q), _mm_loadu_si128(q + 1));
+}
+
+/**@brief SSE2 version of case_fold_prefix()*/
+template <class Unit>
+inline size_t case_fold_prefix_sse2(const Unit* a, const Unit* b, size_t n)
+{
+  // saturated lanes are in no range
+  const case_sse2_mapper<short> m(case_to_lower);
+  size_t k = 0;
+  for(; n - k >= 8; k += 8)
+  {
+    __m128i known_a, known_b;
+    const __m128i fa = m.map(case_simd_load8(a + k), known_a);
+    const __m128i fb = m.map(case_simd_load8(b + k), known_b);
+    const __m128i same = _mm_and_si128(_mm_and_si128(known_a, known_b),
+                                       _mm_cmpeq_epi16(fa, fb));
+    if(_mm_movemask_epi8(same) != 0xFFFF)
+      break;
+  }
+  return k;
+}
+
+/**@brief Lanes of c folding to f: the lanes equal to f or to its upper
+ * case fu, and the lanes out of ASCII and basic Cyrillic, 16-bit lanes*/
+inline __m128i case_simd_folds_to(__m128i c, __m128i f, __m128i fu)
+{
+  // unsigned c <= 0x7F and c - 0x400 <= 0x5F
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i basic = _mm_or_si128(
+      _mm_cmpeq_epi16(_mm_subs_epu16(c, _mm_set1_epi16(0x7F)), zero),
+      _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(c, _mm_set1_epi16(0x400)),
+                                     _mm_set1_epi16(0x5F)), zero));
+  return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(c, f),
+                                   _mm_cmpeq_epi16(c, fu)),
+                      _mm_xor_si128(basic, _mm_set1_epi16(-1)));
+}
+
+/**@brief SSE2 version of case_fold_filter()*/
+template <class Unit>
+inline size_t case_fold_filter_sse2(const Unit* b, size_t n, size_t m,
+                                    unsigned long first, unsigned long last,
+                                    unsigned& hits)
+{
+  // saturated lanes are out of ASCII and basic Cyrillic
+  const __m128i f = _mm_set1_epi16(static_cast<short>(first));
+  const __m128i fu = _mm_set1_epi16(
+      static_cast<short>(unicode_toupper(first)));
+  const __m128i l = _mm_set1_epi16(static_cast<short>(last));
+  const __m128i lu = _mm_set1_epi16(
+      static_cast<short>(unicode_toupper(last)));
+  size_t k = 0;
+  for(; n - k >= 8; k += 8)
+  {
+    const __m128i hit = _mm_and_si128(
+        case_simd_folds_to(case_simd_load8(b + k), f, fu),
+        case_simd_folds_to(case_simd_load8(b + k + m - 1), l, lu));
+    hits = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_packs_epi16(hit, _mm_setzero_si128())));
+    if(hits != 0)
+      return k;
+  }
+  return k + case_fold_filter_scalar(b + k, n - k, m, first, last, hits);
+}
+
+/**@brief AVX2 lane operations on code units of the given size*/
+template <size_t size>
+struct case_avx2;
+
+template <>
+struct case_avx2<2>
+{
+  FACETS_TARGET_AVX2
+  static __m256i set1(long v)
+  {
+    return _mm256_set1_epi16(static_cast<short>(v));
+  }
+  FACETS_TARGET_AVX2
+  static __m256i cmpgt(__m256i a, __m256i b)
+  {
+    return _mm256_cmpgt_epi16(a, b);
+  }
+  FACETS_TARGET_AVX2
+  static __m256i add(__m256i a, __m256i b)
+  {
+    return _mm256_add_epi16(a, b);
+  }
+};
+
+template <>
+struct case_avx2<4>
+{
+  FACETS_TARGET_AVX2
+  static __m256i set1(long v)
+  {
+    return _mm256_set1_epi32(static_cast<int>(v));
+  }
+  FACETS_TARGET_AVX2
+  static __m256i cmpgt(__m256i a, __m256i b)
+  {
+    return _mm256_cmpgt_epi32(a, b);
+  }
+  FACETS_TARGET_AVX2
+  static __m256i add(__m256i a, __m256i b)
+  {
+    return _mm256_add_epi32(a, b);
+  }
+};
+
+/**@brief Range constants of direction d in AVX2 registers*/
+template <class Unit>
+struct case_avx2_mapper
+{
+  typedef case_avx2<sizeof(Unit)> op;
+
+  __m256i above[case_ranges_count];
+  __m256i below[case_ranges_count];
+  __m256i delta[case_ranges_count];
+  __m256i ascii_above, ascii_below, cyr_above, cyr_below;
+
+  FACETS_TARGET_AVX2
+  explicit case_avx2_mapper(case_direction d)
+  {
+    const case_range* r = case_ranges(d);
+    for(int k = 0; k < case_ranges_count; ++k)
+    {
+      above[k] = op::set1(r[k].first - 1);
+      below[k] = op::set1(r[k].last + 1);
+      delta[k] = op::set1(r[k].delta);
+    }
+    ascii_above = op::set1(-1);
+    ascii_below = op::set1(0x80);
+    cyr_above = op::set1(0x3FF);
+    cyr_below = op::set1(0x460);
+  }
+
+  /**@brief Map ASCII and basic Cyrillic lanes of c, known receives
+   * them*/
+  FACETS_TARGET_AVX2
+  __m256i map(__m256i c, __m256i& known) const
+  {
+    known = _mm256_or_si256(
+        _mm256_and_si256(op::cmpgt(c, ascii_above),
+                         op::cmpgt(ascii_below, c)),
+        _mm256_and_si256(op::cmpgt(c, cyr_above), op::cmpgt(cyr_below, c)));
+    __m256i add = _mm256_setzero_si256();
+    for(int k = 0; k < case_ranges_count; ++k)
+    {
+      const __m256i in = _mm256_and_si256(op::cmpgt(c, above[k]),
+                                          op::cmpgt(below[k], c));
+      add = _mm256_or_si256(add, _mm256_and_si256(in, delta[k]));
+    }
+    return op::add(c, add);
+  }
+};
+
+/**@brief AVX2 version of case_map()*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline void case_map_avx2(const Unit* b, const Unit* e, Unit* o,
+                          case_direction d)
+{
+  enum { lanes = 32 / sizeof(Unit) };
+  const case_avx2_mapper<Unit> m(d);
+  const Unit* i = b;
+  for(; e - i >= lanes; i += lanes, o += lanes)
+  {
+    __m256i known;
+    const __m256i c = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), m.map(c, known));
+    const unsigned miss = ~static_cast<unsigned>(_mm256_movemask_epi8(known));
+    case_simd_patch(i, o, miss, d);
+  }
+  case_map_sse2(i, e, o, d);
+}
+
+/**@brief Load 16 code units to 16-bit lanes, saturating 32-bit ones*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline __m256i case_simd_load16(const Unit* p)
+{
+  const __m256i* q = reinterpret_cast<const __m256i*>(p);
+  if(sizeof(Unit) == 2)
+    return _mm256_loadu_si256(q);
+  // packs works within 128-bit lanes
+  return _mm256_permute4x64_epi64(
+      _mm256_packs_epi32(_mm256_loadu_si256(q), _mm256_loadu_si256(q + 1)),
+      0xD8);
+}
+
+/**@brief AVX2 version of case_fold_prefix()*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline size_t case_fold_prefix_avx2(const Unit* a, const Unit* b, size_t n)
+{
+  const case_avx2_mapper<short> m(case_to_lower);
+  size_t k = 0;
+  for(; n - k >= 16; k += 16)
+  {
+    __m256i known_a, known_b;
+    const __m256i fa = m.map(case_simd_load16(a + k), known_a);
+    const __m256i fb = m.map(case_simd_load16(b + k), known_b);
+    const __m256i same = _mm256_and_si256(
+        _mm256_and_si256(known_a, known_b), _mm256_cmpeq_epi16(fa, fb));
+    if(_mm256_movemask_epi8(same) != -1)
+      break;
+  }
+  return k + case_fold_prefix_sse2(a + k, b + k, n - k);
+}
+
+/**@brief AVX2 version of case_simd_folds_to()*/
+FACETS_TARGET_AVX2
+inline __m256i case_simd_folds_to(__m256i c, __m256i f, __m256i fu)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i basic = _mm256_or_si256(
+      _mm256_cmpeq_epi16(_mm256_subs_epu16(c, _mm256_set1_epi16(0x7F)),
+                         zero),
+      _mm256_cmpeq_epi16(
+          _mm256_subs_epu16(_mm256_sub_epi16(c, _mm256_set1_epi16(0x400)),
+                            _mm256_set1_epi16(0x5F)), zero));
+  return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi16(c, f),
+                                         _mm256_cmpeq_epi16(c, fu)),
+                         _mm256_xor_si256(basic, _mm256_set1_epi16(-1)));
+}
+
+/**@brief AVX2 version of case_fold_filter()*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline size_t case_fold_filter_avx2(const Unit* b, size_t n, size_t m,
+                                    unsigned long first, unsigned long last,
+                                    unsigned& hits)
+{
+  const __m256i f = _mm256_set1_epi16(static_cast<short>(first));
+  const __m256i fu = _mm256_set1_epi16(
+      static_cast<short>(unicode_toupper(first)));
+  const __m256i l = _mm256_set1_epi16(static_cast<short>(last));
+  const __m256i lu = _mm256_set1_epi16(
+      static_cast<short>(unicode_toupper(last)));
+  size_t k = 0;
+  for(; n - k >= 16; k += 16)
+  {
+    const __m256i hit = _mm256_and_si256(
+        case_simd_folds_to(case_simd_load16(b + k), f, fu),
+        case_simd_folds_to(case_simd_load16(b + k + m - 1), l, lu));
+    // packs works within 128-bit lanes: positions 0..7 in bits 0..7,
+    // 8..15 in bits 16..23
+    const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_packs_epi16(hit, _mm256_setzero_si256())));
+    hits = (mask & 0xFF) | ((mask >> 8) & 0xFF00);
+    if(hits != 0)
+      return k;
+  }
+  return k + case_fold_filter_sse2(b + k, n - k, m, first, last, hits);
+}
+#endif
+
+/**@brief Map UNICODE string [b, e) to upper or lower case into o
+ *
+ * One code unit is written per character, o may be b. Mapping is the
+ * simple one of ctype_unicode: characters mapping to several ones (U+00DF
+ * to SS) keep their case. UTF-16 surrogate pairs are kept as they are.*/
+template <class Unit>
+inline void case_map(const Unit* b, const Unit* e, Unit* o,
+                     case_direction d)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef void (*kernel)(const Unit*, const Unit*, Unit*, case_direction);
+  static const kernel kernels[simd_levels] =
+  {
+    &case_map_scalar<Unit>,
+    &case_map_sse2<Unit>,
+    &case_map_avx2<Unit>,
+    &case_map_avx2<Unit>
+  };
+  if(e - b >= 8)
+    return kernels[simd_active()](b, e, o, d);
+#endif
+  case_map_scalar(b, e, o, d);
+}
+
+/**@brief Scalar version of case_fold_prefix(), leaves everything to the
+ * caller*/
+template <class Unit>
+inline size_t case_fold_prefix_scalar(const Unit*, const Unit*, size_t)
+{
+  return 0;
+}
+
+/**@brief Length of the common prefix of a and b, both n units long, when
+ * case folded
+ *
+ * Only whole blocks of ASCII and basic Cyrillic characters are matched,
+ * the prefix may be shorter than the real one. Folding of these is the
+ * lower case mapping.*/
+template <class Unit>
+inline size_t case_fold_prefix(const Unit* a, const Unit* b, size_t n)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const Unit*, const Unit*, size_t);
+  static const kernel kernels[simd_levels] =
+  {
+    &case_fold_prefix_scalar<Unit>,
+    &case_fold_prefix_sse2<Unit>,
+    &case_fold_prefix_avx2<Unit>,
+    &case_fold_prefix_avx2<Unit>
+  };
+  if(n >= 8)
+    return kernels[simd_active()](a, b, n);
+#endif
+  return case_fold_prefix_scalar(a, b, n);
+}
+
+/**@brief Find the first block of candidates among n positions in b
+ * where a string of length m may start that begins with a character
+ * folding to first and ends with one folding to last, see
+ * case_fold_find()
+ * @param hits receives the candidates of the block, bit i for the
+ * position at the returned offset plus i
+ * @return offset of the block, n if there are no candidates
+ *
+ * Units b[0] .. b[n + m - 2] are read. The filter is exact when first,
+ * last and the characters at both ends are ASCII or basic Cyrillic,
+ * positions with other characters at either end are always candidates.*/
+template <class Unit>
+inline size_t case_fold_filter(const Unit* b, size_t n, size_t m,
+                               unsigned long first, unsigned long last,
+                               unsigned& hits)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const Unit*, size_t, size_t, unsigned long,
+                           unsigned long, unsigned&);
+  static const kernel kernels[simd_levels] =
+  {
+    &case_fold_filter_scalar<Unit>,
+    &case_fold_filter_sse2<Unit>,
+    &case_fold_filter_avx2<Unit>,
+    &case_fold_filter_avx2<Unit>
+  };
+  if(n >= 8)
+    return kernels[simd_active()](b, n, m, first, last, hits);
+#endif
+  return case_fold_filter_scalar(b, n, m, first, last, hits);
+}
+
+#endif // __CASE_SIMD_HPP__
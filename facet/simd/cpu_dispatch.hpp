@@ -0,0 +1,111 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief Runtime selection of SIMD kernels.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * Kernels of every instruction set level are compiled into the binary
+ * with target attributes, so one build runs on any x86-64 host. The level
+ * is detected once, on the first call, and kernels are called through
+ * function pointer tables indexed by it:
+ * @code
+ *  typedef size_t (*kernel)(const char*, const char*);
+ *  static const kernel kernels[simd_levels] = { ... };
+ *  return kernels[simd_active()](b, e);
+ * @endcode
+ * The level can be lowered for tests and benchmarks with simd_set_level()
+ * or with the FACETS_SIMD environment variable (scalar, sse2, avx2 or
+ * avx512), read at detection. Other compilers and targets get the scalar
+ * kernels.*/
+
+#ifndef __CPU_DISPATCH_HPP__
+#define __CPU_DISPATCH_HPP__
+
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#  define FACETS_SIMD_X86 1
+#  define FACETS_TARGET_AVX2 __attribute__((target("avx2")))
+#  define FACETS_TARGET_AVX512 \
+     __attribute__((target("avx2,avx512f,avx512bw,avx512vbmi")))
+#  include <immintrin.h>
+#endif
+
+/**@brief Instruction set levels, each one implies the previous*/
+enum simd_level
+{
+  simd_scalar, // portable C++
+  simd_sse2,   // x86-64 baseline
+  simd_avx2,   // Haswell and later
+  simd_avx512  // AVX-512 F, BW and VBMI: Ice Lake and later
+};
+
+enum { simd_levels = simd_avx512 + 1 };
+
+/**@brief Best level supported by the CPU and the OS*/
+inline simd_level simd_detect()
+{
+#if defined(FACETS_SIMD_X86)
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+     && __builtin_cpu_supports("avx512vbmi"))
+    return simd_avx512;
+  if(__builtin_cpu_supports("avx2"))
+    return simd_avx2;
+  return simd_sse2;
+#else
+  return simd_scalar;
+#endif
+}
+
+/**@brief Level named by FACETS_SIMD, simd_levels if it is not set or
+ * unknown*/
+inline int simd_env_level()
+{
+  static const char* names[simd_levels] =
+    { "scalar", "sse2", "avx2", "avx512" };
+  const char* env = std::getenv("FACETS_SIMD");
+  if(env)
+    for(int level = 0; level < simd_levels; ++level)
+      if(std::strcmp(env, names[level]) == 0)
+        return level;
+  return simd_levels;
+}
+
+/**@brief Detected level, lowered to FACETS_SIMD*/
+inline simd_level simd_initial_level()
+{
+  const simd_level best = simd_detect();
+  const int env = simd_env_level();
+  return env < best ? static_cast<simd_level>(env) : best;
+}
+
+/**@brief Storage of the level in use, set on the first call*/
+inline simd_level& simd_level_ref()
+{
+  static simd_level level = simd_initial_level();
+  return level;
+}
+
+/**@brief Level of the kernels in use*/
+inline simd_level simd_active()
+{
+  return simd_level_ref();
+}
+
+/**@brief Use kernels of the given level, or of the best supported one
+ * below it
+ * @return level actually set
+ *
+ * Meant for tests and benchmarks: not synchronized with conversions
+ * running in other threads.*/
+inline simd_level simd_set_level(simd_level level)
+{
+  const simd_level best = simd_detect();
+  simd_level_ref() = level < best ? level : best;
+  return simd_level_ref();
+}
+
+#endif // __CPU_DISPATCH_HPP__
@@ -0,0 +1,455 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief SIMD kernels used by single-byte codepage conversion routines.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * The upper half of a codepage is a 128-entry table of 16-bit code
+ * points, kept as two byte planes (low and high bytes). A block of input
+ * is translated plane by plane with byte shuffles: AVX-512 VBMI looks up
+ * 64 bytes in a 128-entry plane with one vpermi2b, AVX2 builds the lookup
+ * from eight 16-entry vpshufb and a tree of blends on index bits 4..6.
+ * SSE2 has no byte shuffle and only widens ASCII blocks.
+ *
+ * Encoders compare blocks of characters against ASCII and the linear runs
+ * of sbcs_out_table and compute their bytes with a subtraction. The other
+ * characters are marked in a mask and looked up one by one. Kernels are
+ * selected at run time by cpu_dispatch.hpp.*/
+
+#ifndef __SBCS_SIMD_HPP__
+#define __SBCS_SIMD_HPP__
+
+#include <cstddef>
+
+#include <codecvt/sbcs_table.hpp>
+#include <simd/cpu_dispatch.hpp>
+#include <simd/utf8_simd.hpp>
+
+/**@brief Decoding table of the upper half (0x80..0xFF) of a single-byte
+ * codepage*/
+struct sbcs_planes
+{
+  const wchar_t* upper;   // code points, 0 for unmapped bytes
+  unsigned char lo[128];  // low bytes of upper
+  unsigned char hi[128];  // high bytes of upper
+  bool complete;          // every byte is mapped
+
+  explicit sbcs_planes(const wchar_t* upper_)
+    : upper(upper_),
+      complete(true)
+  {
+    for(int k = 0; k < 128; ++k)
+    {
+      lo[k] = static_cast<unsigned char>(upper[k] & 0xFF);
+      hi[k] = static_cast<unsigned char>((upper[k] >> 8) & 0xFF);
+      if(upper[k] == 0)
+        complete = false;
+    }
+  }
+};
+
+/**@brief Scalar version of sbcs_decode()*/
+template <class Unit>
+inline size_t sbcs_decode_scalar(const char* b, const char* e, Unit* o,
+                                 const sbcs_planes& t)
+{
+  const char* i = b;
+  for(; i != e; ++i, ++o)
+  {
+    const unsigned char c = static_cast<unsigned char>(*i);
+    if(c <= 0x7F)
+      *o = static_cast<Unit>(c);
+    else if((*o = static_cast<Unit>(t.upper[c - 0x80])) == 0)
+      break;
+  }
+  return static_cast<size_t>(i - b);
+}
+
+/**@brief Scalar version of sbcs_encode()*/
+template <class Unit>
+inline size_t sbcs_encode_scalar(const Unit* b, const Unit* e, char* o,
+                                 const sbcs_out_table& t)
+{
+  const Unit* i = b;
+  for(; i != e; ++i, ++o)
+  {
+    if(static_cast<unsigned long>(*i) <= 0x7F)
+      *o = static_cast<char>(*i);
+    else if((*o = static_cast<char>(t.find(static_cast<wchar_t>(*i)))) == 0)
+      break;
+  }
+  return static_cast<size_t>(i - b);
+}
+
+#if defined(FACETS_SIMD_X86)
+/**@brief SSE2 version of sbcs_decode(): ASCII blocks are widened, the
+ * rest is decoded by the scalar loop*/
+template <class Unit>
+inline size_t sbcs_decode_sse2(const char* b, const char* e, Unit* o,
+                               const sbcs_planes& t)
+{
+  const char* i = b;
+  while(e - i >= 16)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+    if(_mm_movemask_epi8(v) == 0)
+      utf8_simd_widen16(v, o);
+    else
+    {
+      const size_t n = sbcs_decode_scalar(i, i + 16, o, t);
+      if(n != 16)
+        return static_cast<size_t>(i - b) + n;
+    }
+    i += 16;
+    o += 16;
+  }
+  return static_cast<size_t>(i - b) + sbcs_decode_scalar(i, e, o, t);
+}
+
+/**@brief Store 32 code points given as low and high byte planes*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline void sbcs_simd_store32(__m256i lo, __m256i hi, Unit* o)
+{
+  const __m256i w0 = _mm256_or_si256(
+      _mm256_cvtepu8_epi16(_mm256_castsi256_si128(lo)),
+      _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(hi)), 8));
+  const __m256i w1 = _mm256_or_si256(
+      _mm256_cvtepu8_epi16(_mm256_extracti128_si256(lo, 1)),
+      _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(hi, 1)),
+                        8));
+  if(sizeof(Unit) == 2)
+  {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), w0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + 16), w1);
+    return;
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(o),
+                      _mm256_cvtepu16_epi32(_mm256_castsi256_si128(w0)));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + 8),
+                      _mm256_cvtepu16_epi32(_mm256_extracti128_si256(w0, 1)));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + 16),
+                      _mm256_cvtepu16_epi32(_mm256_castsi256_si128(w1)));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + 24),
+                      _mm256_cvtepu16_epi32(_mm256_extracti128_si256(w1, 1)));
+}
+
+/**@brief Look up the low 7 bits of every byte of v in a 128-entry plane,
+ * given as eight 16-entry tables broadcast to both lanes
+ * @param m4, m5, m6 v shifted so that index bits 4, 5 and 6 become the
+ * sign bits*/
+FACETS_TARGET_AVX2
+inline __m256i sbcs_simd_lookup128(const __m256i* tab, __m256i idx,
+                                   __m256i m4, __m256i m5, __m256i m6)
+{
+  const __m256i a01 = _mm256_blendv_epi8(_mm256_shuffle_epi8(tab[0], idx),
+                                         _mm256_shuffle_epi8(tab[1], idx), m4);
+  const __m256i a23 = _mm256_blendv_epi8(_mm256_shuffle_epi8(tab[2], idx),
+                                         _mm256_shuffle_epi8(tab[3], idx), m4);
+  const __m256i a45 = _mm256_blendv_epi8(_mm256_shuffle_epi8(tab[4], idx),
+                                         _mm256_shuffle_epi8(tab[5], idx), m4);
+  const __m256i a67 = _mm256_blendv_epi8(_mm256_shuffle_epi8(tab[6], idx),
+                                         _mm256_shuffle_epi8(tab[7], idx), m4);
+  return _mm256_blendv_epi8(_mm256_blendv_epi8(a01, a23, m5),
+                            _mm256_blendv_epi8(a45, a67, m5), m6);
+}
+
+/**@brief AVX2 version of sbcs_decode()*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline size_t sbcs_decode_avx2(const char* b, const char* e, Unit* o,
+                               const sbcs_planes& t)
+{
+  __m256i lo_tab[8], hi_tab[8];
+  for(int k = 0; k < 8; ++k)
+  {
+    lo_tab[k] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.lo + 16*k)));
+    hi_tab[k] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(t.hi + 16*k)));
+  }
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  const char* i = b;
+  while(e - i >= 32)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i));
+    // sign bits mark the upper half
+    const int upper = _mm256_movemask_epi8(v);
+    __m256i lo = v, hi = zero;
+    if(upper != 0)
+    {
+      // a 16-bit shift by k moves bit 7-k of every byte to its sign bit
+      const __m256i idx = _mm256_and_si256(v, nibble);
+      const __m256i m4 = _mm256_slli_epi16(v, 3);
+      const __m256i m5 = _mm256_slli_epi16(v, 2);
+      const __m256i m6 = _mm256_slli_epi16(v, 1);
+      const __m256i ulo = sbcs_simd_lookup128(lo_tab, idx, m4, m5, m6);
+      const __m256i uhi = sbcs_simd_lookup128(hi_tab, idx, m4, m5, m6);
+      // unmapped bytes have a zero code point
+      const int unmapped = _mm256_movemask_epi8(
+          _mm256_cmpeq_epi8(_mm256_or_si256(ulo, uhi), zero)) & upper;
+      if(unmapped != 0)
+        break;
+      lo = _mm256_blendv_epi8(v, ulo, v);
+      hi = _mm256_blendv_epi8(zero, uhi, v);
+    }
+    sbcs_simd_store32(lo, hi, o);
+    i += 32;
+    o += 32;
+  }
+  return static_cast<size_t>(i - b) + sbcs_decode_sse2(i, e, o, t);
+}
+
+/**@brief Interleave elements of a and b: lanes of unpacklo(a, b) and
+ * unpackhi(a, b) are put in order, the first half goes to first*/
+FACETS_TARGET_AVX512
+inline void sbcs_simd_zip512(__m512i lo, __m512i hi,
+                             __m512i& first, __m512i& second)
+{
+  first = _mm512_permutex2var_epi64(
+      lo, _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0), hi);
+  second = _mm512_permutex2var_epi64(
+      lo, _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4), hi);
+}
+
+/**@brief Store 64 code points given as low and high byte planes*/
+template <class Unit>
+FACETS_TARGET_AVX512
+inline void sbcs_simd_store64(__m512i lo, __m512i hi, Unit* o)
+{
+  __m512i w[2];
+  sbcs_simd_zip512(_mm512_unpacklo_epi8(lo, hi), _mm512_unpackhi_epi8(lo, hi),
+                   w[0], w[1]);
+  if(sizeof(Unit) == 2)
+  {
+    _mm512_storeu_si512(o, w[0]);
+    _mm512_storeu_si512(o + 32, w[1]);
+    return;
+  }
+  const __m512i zero = _mm512_setzero_si512();
+  for(int k = 0; k < 2; ++k, o += 32)
+  {
+    __m512i d0, d1;
+    sbcs_simd_zip512(_mm512_unpacklo_epi16(w[k], zero),
+                     _mm512_unpackhi_epi16(w[k], zero), d0, d1);
+    _mm512_storeu_si512(o, d0);
+    _mm512_storeu_si512(o + 16, d1);
+  }
+}
+
+/**@brief AVX-512 VBMI version of sbcs_decode()*/
+template <class Unit>
+FACETS_TARGET_AVX512
+inline size_t sbcs_decode_avx512(const char* b, const char* e, Unit* o,
+                                 const sbcs_planes& t)
+{
+  const __m512i lo0 = _mm512_loadu_si512(t.lo);
+  const __m512i lo1 = _mm512_loadu_si512(t.lo + 64);
+  const __m512i hi0 = _mm512_loadu_si512(t.hi);
+  const __m512i hi1 = _mm512_loadu_si512(t.hi + 64);
+  const __m512i zero = _mm512_setzero_si512();
+  const char* i = b;
+  while(e - i >= 64)
+  {
+    const __m512i v = _mm512_loadu_si512(i);
+    const __mmask64 upper = _mm512_movepi8_mask(v);
+    __m512i lo = v, hi = zero;
+    if(upper != 0)
+    {
+      // index bit 6 selects the second half of the plane, bit 7 is ignored
+      const __m512i ulo = _mm512_permutex2var_epi8(lo0, v, lo1);
+      const __m512i uhi = _mm512_permutex2var_epi8(hi0, v, hi1);
+      if(_mm512_mask_cmpeq_epi8_mask(upper, _mm512_or_si512(ulo, uhi), zero))
+        break;
+      lo = _mm512_mask_blend_epi8(upper, v, ulo);
+      hi = _mm512_maskz_mov_epi8(upper, uhi);
+    }
+    sbcs_simd_store64(lo, hi, o);
+    i += 64;
+    o += 64;
+  }
+  return static_cast<size_t>(i - b) + sbcs_decode_avx2(i, e, o, t);
+}
+/**@brief Look up the characters of a block marked in miss
+ * @return offset of the first unmapped one, n if all are mapped*/
+template <class Unit>
+inline int sbcs_simd_patch(const Unit* i, char* o, unsigned miss, int n,
+                           const sbcs_out_table& t)
+{
+  for(; miss != 0; miss &= miss - 1)
+  {
+    const int k = __builtin_ctz(miss);
+    if((o[k] = static_cast<char>(t.find(static_cast<wchar_t>(i[k])))) == 0)
+      return k;
+  }
+  return n;
+}
+
+/**@brief Load 8 code units to 16-bit lanes, saturating 32-bit ones*/
+template <class Unit>
+inline __m128i sbcs_simd_load8(const Unit* p)
+{
+  const __m128i* q = reinterpret_cast<const __m128i*>(p);
+  if(sizeof(Unit) == 2)
+    return _mm_loadu_si128(q);
+  return _mm_packs_epi32(_mm_loadu_si128(q), _mm_loadu_si128(q + 1));
+}
+
+/**@brief SSE2 version of sbcs_encode()*/
+template <class Unit>
+inline size_t sbcs_encode_sse2(const Unit* b, const Unit* e, char* o,
+                               const sbcs_out_table& t)
+{
+  // ASCII and the runs: first - 1, last + 1 and delta
+  enum { ranges = sbcs_out_table::max_runs + 1 };
+  __m128i above[ranges], below[ranges], delta[ranges];
+  above[0] = _mm_set1_epi16(-1);
+  below[0] = _mm_set1_epi16(0x80);
+  delta[0] = _mm_setzero_si128();
+  for(int k = 1; k < ranges; ++k)
+  {
+    const sbcs_run& run = t.runs()[k - 1];
+    above[k] = _mm_set1_epi16(static_cast<short>(run.first - 1));
+    below[k] = _mm_set1_epi16(static_cast<short>(run.last + 1));
+    delta[k] = _mm_set1_epi16(static_cast<short>(run.delta));
+  }
+  const Unit* i = b;
+  for(; e - i >= 8; i += 8, o += 8)
+  {
+    // saturated and negative lanes are in no range
+    const __m128i c = sbcs_simd_load8(i);
+    __m128i hit = _mm_setzero_si128(), bytes = _mm_setzero_si128();
+    for(int k = 0; k < ranges; ++k)
+    {
+      const __m128i in = _mm_and_si128(_mm_cmpgt_epi16(c, above[k]),
+                                       _mm_cmplt_epi16(c, below[k]));
+      hit = _mm_or_si128(hit, in);
+      bytes = _mm_or_si128(bytes,
+                           _mm_and_si128(in, _mm_sub_epi16(c, delta[k])));
+    }
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(o),
+                     _mm_packus_epi16(bytes, bytes));
+    const unsigned miss = ~_mm_movemask_epi8(_mm_packs_epi16(hit, hit)) & 0xFF;
+    const int n = sbcs_simd_patch(i, o, miss, 8, t);
+    if(n != 8)
+      return static_cast<size_t>(i - b) + n;
+  }
+  return static_cast<size_t>(i - b) + sbcs_encode_scalar(i, e, o, t);
+}
+
+/**@brief Load 16 code units to 16-bit lanes, saturating 32-bit ones*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline __m256i sbcs_simd_load16(const Unit* p)
+{
+  const __m256i* q = reinterpret_cast<const __m256i*>(p);
+  if(sizeof(Unit) == 2)
+    return _mm256_loadu_si256(q);
+  // packs works within 128-bit lanes
+  return _mm256_permute4x64_epi64(
+      _mm256_packs_epi32(_mm256_loadu_si256(q), _mm256_loadu_si256(q + 1)),
+      0xD8);
+}
+
+/**@brief AVX2 version of sbcs_encode()*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline size_t sbcs_encode_avx2(const Unit* b, const Unit* e, char* o,
+                               const sbcs_out_table& t)
+{
+  // ASCII and the runs: first - 1, last + 1 and delta
+  enum { ranges = sbcs_out_table::max_runs + 1 };
+  __m256i above[ranges], below[ranges], delta[ranges];
+  above[0] = _mm256_set1_epi16(-1);
+  below[0] = _mm256_set1_epi16(0x80);
+  delta[0] = _mm256_setzero_si256();
+  for(int k = 1; k < ranges; ++k)
+  {
+    const sbcs_run& run = t.runs()[k - 1];
+    above[k] = _mm256_set1_epi16(static_cast<short>(run.first - 1));
+    below[k] = _mm256_set1_epi16(static_cast<short>(run.last + 1));
+    delta[k] = _mm256_set1_epi16(static_cast<short>(run.delta));
+  }
+  const __m256i low = _mm256_set1_epi16(0xFF);
+  const Unit* i = b;
+  for(; e - i >= 16; i += 16, o += 16)
+  {
+    const __m256i c = sbcs_simd_load16(i);
+    __m256i hit = _mm256_setzero_si256(), bytes = _mm256_setzero_si256();
+    for(int k = 0; k < ranges; ++k)
+    {
+      const __m256i in = _mm256_and_si256(_mm256_cmpgt_epi16(c, above[k]),
+                                          _mm256_cmpgt_epi16(below[k], c));
+      hit = _mm256_or_si256(hit, in);
+      bytes = _mm256_or_si256(
+          bytes, _mm256_and_si256(in, _mm256_sub_epi16(c, delta[k])));
+    }
+    // bytes to the low half, 0xFF for missed characters to the high one
+    const __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(bytes, _mm256_andnot_si256(hit, low)), 0xD8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o),
+                     _mm256_castsi256_si128(packed));
+    const unsigned miss = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm256_extracti128_si256(packed, 1)));
+    const int n = sbcs_simd_patch(i, o, miss, 16, t);
+    if(n != 16)
+      return static_cast<size_t>(i - b) + n;
+  }
+  return static_cast<size_t>(i - b) + sbcs_encode_sse2(i, e, o, t);
+}
+#endif
+
+/**@brief Decode the leading part of single-byte string [b, e) to o
+ * @return number of bytes decoded: e - b, or the offset of the first
+ * unmapped byte
+ *
+ * One code unit is written per decoded byte.*/
+template <class Unit>
+inline size_t sbcs_decode(const char* b, const char* e, Unit* o,
+                          const sbcs_planes& t)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const char*, const char*, Unit*,
+                           const sbcs_planes&);
+  static const kernel kernels[simd_levels] =
+  {
+    &sbcs_decode_scalar<Unit>,
+    &sbcs_decode_sse2<Unit>,
+    &sbcs_decode_avx2<Unit>,
+    &sbcs_decode_avx512<Unit>
+  };
+  if(e - b >= 16)
+    return kernels[simd_active()](b, e, o, t);
+#endif
+  return sbcs_decode_scalar(b, e, o, t);
+}
+
+/**@brief Encode the leading part of UNICODE string [b, e) to o
+ * @return number of characters encoded: e - b, or the offset of the first
+ * one missing in the codepage
+ *
+ * One byte is written per encoded character. Bytes past the returned
+ * offset, up to the end of its block, may be overwritten.*/
+template <class Unit>
+inline size_t sbcs_encode(const Unit* b, const Unit* e, char* o,
+                          const sbcs_out_table& t)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const Unit*, const Unit*, char*,
+                           const sbcs_out_table&);
+  static const kernel kernels[simd_levels] =
+  {
+    &sbcs_encode_scalar<Unit>,
+    &sbcs_encode_sse2<Unit>,
+    &sbcs_encode_avx2<Unit>,
+    &sbcs_encode_avx2<Unit>
+  };
+  if(e - b >= 8)
+    return kernels[simd_active()](b, e, o, t);
+#endif
+  return sbcs_encode_scalar(b, e, o, t);
+}
+
+#endif // __SBCS_SIMD_HPP__
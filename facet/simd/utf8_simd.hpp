@@ -0,0 +1,547 @@
+/**@author hoxnox <hoxnox@gmail.com>
+ * @copyright (c) 2026 hoxnox <hoxnox@gmail.com>
+ * @license LGPL
+ * @brief SIMD kernels used by UTF-8 conversion routines.
+ *
+ * This file is a part of hoxnox's facets project
+ *
+ * Kernels work on contiguous buffers only. Every kernel has a scalar,
+ * an SSE2 and, where it pays, an AVX2 version, selected at run time by
+ * cpu_dispatch.hpp. Inputs shorter than one block go to the scalar
+ * version directly.
+ *
+ * Wide side kernels are templates on the code unit: 16-bit units (UTF-16
+ * wchar_t, char16_t) and 32-bit units (UTF-32 wchar_t, char32_t) are
+ * supported, the width is selected at compile time by sizeof.*/
+
+#ifndef __UTF8_SIMD_HPP__
+#define __UTF8_SIMD_HPP__
+
+#include <cstddef>
+#include <cstring>
+
+#include <simd/cpu_dispatch.hpp>
+
+/**@brief Is c the high (leading) half of a UTF-16 surrogate pair*/
+template <class Unit>
+inline bool utf16_high_surrogate(Unit c)
+{
+  return (static_cast<unsigned long>(c) & 0xFFFFFC00ul) == 0xD800;
+}
+
+/**@brief Is c the low (trailing) half of a UTF-16 surrogate pair*/
+template <class Unit>
+inline bool utf16_low_surrogate(Unit c)
+{
+  return (static_cast<unsigned long>(c) & 0xFFFFFC00ul) == 0xDC00;
+}
+
+/**@brief Widen the leading ASCII run of [b, e) into o, scalar version*/
+template <class Unit>
+inline size_t utf8_widen_ascii_scalar(const char* b, const char* e, Unit* o)
+{
+  const char* i = b;
+  while(i != e && static_cast<unsigned char>(*i) <= 0x7F)
+    *o++ = static_cast<Unit>(*i++);
+  return static_cast<size_t>(i - b);
+}
+
+#if defined(FACETS_SIMD_X86)
+/**@brief Store 16 zero-extended bytes as code units*/
+template <class Unit>
+inline void utf8_simd_widen16(__m128i v, Unit* o)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i lo = _mm_unpacklo_epi8(v, zero);
+  const __m128i hi = _mm_unpackhi_epi8(v, zero);
+  if(sizeof(Unit) == 2)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 8), hi);
+  }
+  else
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o),
+                     _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 4),
+                     _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 8),
+                     _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 12),
+                     _mm_unpackhi_epi16(hi, zero));
+  }
+}
+
+/**@brief Widen the leading ASCII run of [b, e) into o, SSE2 version*/
+template <class Unit>
+inline size_t utf8_widen_ascii_sse2(const char* b, const char* e, Unit* o)
+{
+  const char* i = b;
+  while(e - i >= 16)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+    if(_mm_movemask_epi8(v) != 0)
+      break;
+    utf8_simd_widen16(v, o);
+    i += 16;
+    o += 16;
+  }
+  return static_cast<size_t>(i - b)
+       + utf8_widen_ascii_scalar(i, e, o);
+}
+
+/**@brief Widen the leading ASCII run of [b, e) into o, AVX2 version*/
+template <class Unit>
+FACETS_TARGET_AVX2
+inline size_t utf8_widen_ascii_avx2(const char* b, const char* e, Unit* o)
+{
+  const char* i = b;
+  while(e - i >= 32)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i));
+    if(_mm256_movemask_epi8(v) != 0)
+      break;
+    if(sizeof(Unit) == 2)
+    {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(o),
+                      _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + 16),
+                      _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+    }
+    else
+    {
+      for(int k = 0; k < 32; k += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + k),
+                            _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                              reinterpret_cast<const __m128i*>(i + k))));
+    }
+    i += 32;
+    o += 32;
+  }
+  return static_cast<size_t>(i - b) + utf8_widen_ascii_sse2(i, e, o);
+}
+#endif
+
+/**@brief Widen the leading ASCII run of [b, e) into o
+ * @return number of bytes consumed, i.e. the offset of the first byte
+ * greater than 0x7F or e - b
+ *
+ * Exactly one code unit is written per consumed byte, so the output
+ * buffer needs no slack.*/
+template <class Unit>
+inline size_t utf8_widen_ascii(const char* b, const char* e, Unit* o)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const char*, const char*, Unit*);
+  static const kernel kernels[simd_levels] =
+  {
+    &utf8_widen_ascii_scalar<Unit>,
+    &utf8_widen_ascii_sse2<Unit>,
+    &utf8_widen_ascii_avx2<Unit>,
+    &utf8_widen_ascii_avx2<Unit>
+  };
+  if(e - b >= 16)
+    return kernels[simd_active()](b, e, o);
+#endif
+  return utf8_widen_ascii_scalar(b, e, o);
+}
+
+/**@brief Length of the leading ASCII run of [b, e), scalar version*/
+inline size_t utf8_ascii_length_scalar(const char* b, const char* e)
+{
+  const char* i = b;
+  while(i != e && static_cast<unsigned char>(*i) <= 0x7F)
+    ++i;
+  return static_cast<size_t>(i - b);
+}
+
+#if defined(FACETS_SIMD_X86)
+/**@brief Length of the leading ASCII run of [b, e), SSE2 version*/
+inline size_t utf8_ascii_length_sse2(const char* b, const char* e)
+{
+  const char* i = b;
+  while(e - i >= 16)
+  {
+    // the scalar loop finds the byte within the block
+    if(_mm_movemask_epi8(
+         _mm_loadu_si128(reinterpret_cast<const __m128i*>(i))) != 0)
+      break;
+    i += 16;
+  }
+  return static_cast<size_t>(i - b) + utf8_ascii_length_scalar(i, e);
+}
+
+/**@brief Length of the leading ASCII run of [b, e), AVX2 version*/
+FACETS_TARGET_AVX2
+inline size_t utf8_ascii_length_avx2(const char* b, const char* e)
+{
+  const char* i = b;
+  while(e - i >= 32)
+  {
+    if(_mm256_movemask_epi8(
+         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i))) != 0)
+      break;
+    i += 32;
+  }
+  return static_cast<size_t>(i - b) + utf8_ascii_length_sse2(i, e);
+}
+#endif
+
+/**@brief Length of the leading ASCII run of [b, e)*/
+inline size_t utf8_ascii_length(const char* b, const char* e)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const char*, const char*);
+  static const kernel kernels[simd_levels] =
+  {
+    &utf8_ascii_length_scalar,
+    &utf8_ascii_length_sse2,
+    &utf8_ascii_length_avx2,
+    &utf8_ascii_length_avx2
+  };
+  if(e - b >= 16)
+    return kernels[simd_active()](b, e);
+#endif
+  return utf8_ascii_length_scalar(b, e);
+}
+
+/**@brief Encode the leading ASCII run of [i, e), scalar version of
+ * utf8_narrow_block()*/
+template <class Unit>
+inline void utf8_narrow_block_scalar(const Unit* &i, const Unit* e, char* &o)
+{
+  while(i != e && static_cast<unsigned long>(*i) <= 0x7F)
+    *o++ = static_cast<char>(*i++);
+}
+
+#if defined(FACETS_SIMD_X86)
+/**@brief Load 8 code units as 16-bit lanes
+ *
+ * 32-bit code points are packed with signed saturation: everything above
+ * 0x7FFF (and every negative value) keeps bits in 0xF800, so the range
+ * checks of the encoder still reject them.*/
+template <class Unit>
+inline __m128i utf8_simd_load8(const Unit* i)
+{
+  if(sizeof(Unit) == 2)
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+  return _mm_packs_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(i)),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(i + 4)));
+}
+
+/**@brief SSE2 version of utf8_narrow_block()*/
+template <class Unit>
+inline void utf8_narrow_block_sse2(const Unit* &i, const Unit* e, char* &o)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i not_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i not_2byte = _mm_set1_epi16(static_cast<short>(0xF800));
+  while(e - i >= 16)
+  {
+    // pure ASCII: narrow 16 characters with one pack
+    const __m128i a = utf8_simd_load8(i);
+    const __m128i b = utf8_simd_load8(i + 8);
+    const __m128i high = _mm_and_si128(_mm_or_si128(a, b), not_ascii);
+    if(_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm_packus_epi16(a, b));
+    i += 16;
+    o += 16;
+  }
+  while(e - i >= 8)
+  {
+    const __m128i w = utf8_simd_load8(i);
+    if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(w, not_2byte),
+                                         zero)) != 0xFFFF)
+      break;
+    const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(w, not_ascii), zero);
+    const int ascii_mask = _mm_movemask_epi8(ascii);
+    if(ascii_mask == 0xFFFF)
+    {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(o), _mm_packus_epi16(w, w));
+      i += 8;
+      o += 8;
+      continue;
+    }
+    // 110xxxxx 10xxxxxx for every lane: lead in the low byte, trail in the
+    // high one, so a little-endian 16-bit store emits them in order
+    const __m128i lead = _mm_or_si128(_mm_srli_epi16(w, 6),
+                                      _mm_set1_epi16(0xC0));
+    const __m128i trail = _mm_or_si128(_mm_and_si128(w, _mm_set1_epi16(0x3F)),
+                                       _mm_set1_epi16(0x80));
+    const __m128i pair = _mm_or_si128(lead, _mm_slli_epi16(trail, 8));
+    const __m128i out = _mm_or_si128(_mm_and_si128(ascii, w),
+                                     _mm_andnot_si128(ascii, pair));
+    unsigned short units[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(units), out);
+    // every lane but the last stores 2 bytes and advances by its length,
+    // the spare byte of an ASCII lane is overwritten by the next one
+    for(int k = 0; k < 7; ++k)
+    {
+      std::memcpy(o, &units[k], 2);
+      o += 2 - ((ascii_mask >> (2*k)) & 1);
+    }
+    if(ascii_mask & (1 << 14))
+      *o++ = static_cast<char>(units[7]);
+    else
+    {
+      std::memcpy(o, &units[7], 2);
+      o += 2;
+    }
+    i += 8;
+  }
+  utf8_narrow_block_scalar(i, e, o);
+}
+#endif
+
+/**@brief Encode the leading part of [i, e) which consists of code points
+ * below U+0800
+ *
+ * Stops at the first block holding a 3 or 4 byte character, the caller
+ * encodes it and calls again. Advances i and o. Nothing is written past
+ * the encoding of the consumed characters, so an exactly sized output is
+ * enough.*/
+template <class Unit>
+inline void utf8_narrow_block(const Unit* &i, const Unit* e, char* &o)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef void (*kernel)(const Unit*&, const Unit*, char*&);
+  static const kernel kernels[simd_levels] =
+  {
+    &utf8_narrow_block_scalar<Unit>,
+    &utf8_narrow_block_sse2<Unit>,
+    &utf8_narrow_block_sse2<Unit>,
+    &utf8_narrow_block_sse2<Unit>
+  };
+  if(e - i >= 8)
+  {
+    kernels[simd_active()](i, e, o);
+    return;
+  }
+#endif
+  utf8_narrow_block_scalar(i, e, o);
+}
+
+/**@brief Scalar version of utf8_count_leads()*/
+inline size_t utf8_count_leads_scalar(const char* b, const char* e,
+                                      bool pairs)
+{
+  size_t n = 0;
+  for(const char* i = b; i != e; ++i)
+  {
+    const unsigned char c = static_cast<unsigned char>(*i);
+    n += (c & 0xC0) != 0x80;
+    if(pairs)
+      n += c >= 0xF0;
+  }
+  return n;
+}
+
+#if defined(FACETS_SIMD_X86)
+/**@brief SSE2 version of utf8_count_leads()*/
+inline size_t utf8_count_leads_sse2(const char* b, const char* e, bool pairs)
+{
+  size_t n = 0;
+  const char* i = b;
+  // byte counters overflow after 255 blocks, after 127 when a byte may
+  // count twice
+  const int steps = pairs ? 127 : 255;
+  // signed compare: continuation bytes are -128..-65
+  const __m128i cont_max = _mm_set1_epi8(static_cast<char>(0xBF));
+  const __m128i lead4 = _mm_set1_epi8(static_cast<char>(pairs ? 0xF0 : 0));
+  while(e - i >= 16)
+  {
+    __m128i acc = _mm_setzero_si128();
+    for(int k = 0; k < steps && e - i >= 16; ++k, i += 16)
+    {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
+      acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(v, cont_max));
+      if(pairs)
+        acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_and_si128(v, lead4),
+                                               lead4));
+    }
+    const __m128i sum = _mm_sad_epu8(acc, _mm_setzero_si128());
+    n += static_cast<size_t>(_mm_cvtsi128_si32(sum))
+       + static_cast<size_t>(_mm_extract_epi16(sum, 4));
+  }
+  return n + utf8_count_leads_scalar(i, e, pairs);
+}
+
+/**@brief AVX2 version of utf8_count_leads()*/
+FACETS_TARGET_AVX2
+inline size_t utf8_count_leads_avx2(const char* b, const char* e, bool pairs)
+{
+  size_t n = 0;
+  const char* i = b;
+  const int steps = pairs ? 127 : 255;
+  const __m256i cont_max = _mm256_set1_epi8(static_cast<char>(0xBF));
+  const __m256i lead4 = _mm256_set1_epi8(static_cast<char>(pairs ? 0xF0 : 0));
+  while(e - i >= 32)
+  {
+    __m256i acc = _mm256_setzero_si256();
+    for(int k = 0; k < steps && e - i >= 32; ++k, i += 32)
+    {
+      const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i));
+      acc = _mm256_sub_epi8(acc, _mm256_cmpgt_epi8(v, cont_max));
+      if(pairs)
+        acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(
+                _mm256_and_si256(v, lead4), lead4));
+    }
+    const __m256i sum = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+    n += static_cast<size_t>(_mm256_extract_epi64(sum, 0))
+       + static_cast<size_t>(_mm256_extract_epi64(sum, 1))
+       + static_cast<size_t>(_mm256_extract_epi64(sum, 2))
+       + static_cast<size_t>(_mm256_extract_epi64(sum, 3));
+  }
+  return n + utf8_count_leads_sse2(i, e, pairs);
+}
+#endif
+
+/**@brief Count the bytes of [b, e) that are not continuation bytes
+ * (10xxxxxx), counting 4-byte sequence leads (11110xxx and above) twice
+ * if pairs is set*/
+inline size_t utf8_count_leads(const char* b, const char* e, bool pairs)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const char*, const char*, bool);
+  static const kernel kernels[simd_levels] =
+  {
+    &utf8_count_leads_scalar,
+    &utf8_count_leads_sse2,
+    &utf8_count_leads_avx2,
+    &utf8_count_leads_avx2
+  };
+  if(e - b >= 16)
+    return kernels[simd_active()](b, e, pairs);
+#endif
+  return utf8_count_leads_scalar(b, e, pairs);
+}
+
+/**@brief Number of code points in UTF-8 sequence [b, e)
+ *
+ * Counts the bytes that are not continuation bytes (10xxxxxx). For valid
+ * input that is exactly the number of decoded characters.*/
+inline size_t utf8_char_count(const char* b, const char* e)
+{
+  return utf8_count_leads(b, e, false);
+}
+
+/**@brief Number of Unit code units UTF-8 sequence [b, e) decodes to
+ *
+ * Same as utf8_char_count() for 32-bit units. 16-bit units need two for
+ * every character above U+FFFF, i.e. for every 4-byte sequence.*/
+template <class Unit>
+inline size_t utf8_unit_count(const char* b, const char* e)
+{
+  return utf8_count_leads(b, e, sizeof(Unit) == 2);
+}
+
+/**@brief Number of bytes wcstombs produces for one code unit, taken
+ * alone*/
+template <class Unit>
+inline size_t utf8_byte_count(Unit u)
+{
+  const long c = static_cast<long>(u);
+  if(c < 0 || c > 0x1FFFFF)
+    return 0;
+  return 1 + (c > 0x7F) + (c > 0x7FF) + (c > 0xFFFF);
+}
+
+/**@brief Number of bytes wcstombs produces for the code unit at i of
+ * [b, e)
+ *
+ * A surrogate pair of 16-bit units is one 4-byte character: its high half
+ * counts 4 bytes and its low half none. Unpaired surrogates count 3 bytes
+ * like any other unit below U+10000.*/
+template <class Unit>
+inline size_t utf8_byte_count(const Unit* b, const Unit* i, const Unit* e)
+{
+  if(sizeof(Unit) == 2)
+  {
+    if(utf16_high_surrogate(*i) && i + 1 != e && utf16_low_surrogate(i[1]))
+      return 4;
+    if(utf16_low_surrogate(*i) && i != b && utf16_high_surrogate(i[-1]))
+      return 0;
+  }
+  return utf8_byte_count(*i);
+}
+
+/**@brief Scalar version of utf8_byte_count(), counting [i, e) of [b, e)*/
+template <class Unit>
+inline size_t utf8_byte_count_scalar(const Unit* b, const Unit* i,
+                                     const Unit* e)
+{
+  size_t n = 0;
+  for(; i != e; ++i)
+    n += utf8_byte_count(b, i, e);
+  return n;
+}
+
+#if defined(FACETS_SIMD_X86)
+/**@brief SSE2 version of utf8_byte_count()
+ *
+ * Blocks are counted in 16-bit lanes: a block holding anything at or
+ * above U+7FFF (saturated by the pack, or negative as a 16-bit lane,
+ * which covers the surrogates) is counted by the scalar rule.*/
+template <class Unit>
+inline size_t utf8_byte_count_sse2(const Unit* b, const Unit* i,
+                                   const Unit* e)
+{
+  size_t n = 0;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max1 = _mm_set1_epi16(0x7F);
+  const __m128i max2 = _mm_set1_epi16(0x7FF);
+  const __m128i sat = _mm_set1_epi16(0x7FFF);
+  while(e - i >= 8)
+  {
+    // 16-bit lane counters get at most 2 per step
+    __m128i acc = zero;
+    for(int k = 0; k < 0x3FFF && e - i >= 8; ++k, i += 8)
+    {
+      const __m128i w = utf8_simd_load8(i);
+      const __m128i wide = _mm_or_si128(_mm_cmpeq_epi16(w, sat),
+                                        _mm_cmplt_epi16(w, zero));
+      if(_mm_movemask_epi8(wide) != 0)
+      {
+        for(int j = 0; j < 8; ++j)
+          n += utf8_byte_count(b, i + j, e);
+        continue;
+      }
+      n += 8;
+      acc = _mm_sub_epi16(acc, _mm_cmpgt_epi16(w, max1));
+      acc = _mm_sub_epi16(acc, _mm_cmpgt_epi16(w, max2));
+    }
+    unsigned lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes),
+                     _mm_madd_epi16(acc, _mm_set1_epi16(1)));
+    n += static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+  }
+  return n + utf8_byte_count_scalar(b, i, e);
+}
+#endif
+
+/**@brief Number of bytes wcstombs produces for [b, e)
+ *
+ * Characters wcstombs can't encode (negative or above 0x1FFFFF) count as
+ * zero bytes.*/
+template <class Unit>
+inline size_t utf8_byte_count(const Unit* b, const Unit* e)
+{
+#if defined(FACETS_SIMD_X86)
+  typedef size_t (*kernel)(const Unit*, const Unit*, const Unit*);
+  static const kernel kernels[simd_levels] =
+  {
+    &utf8_byte_count_scalar<Unit>,
+    &utf8_byte_count_sse2<Unit>,
+    &utf8_byte_count_sse2<Unit>,
+    &utf8_byte_count_sse2<Unit>
+  };
+  if(e - b >= 8)
+    return kernels[simd_active()](b, b, e);
+#endif
+  return utf8_byte_count_scalar(b, b, e);
+}
+
+#endif // __UTF8_SIMD_HPP__
@@ -0,0 +1,172 @@
+/**@file src/lazy_string.cpp
+ * @author Nosov Yuri <hoxnox@gmail.com>
+ * @date 2026-10-17
+ * @copyright (c) 2026 Nosov Yuri <hoxnox@gmail.com>
+ * @licence ENTY licence
+ *
+ * @brief LazyString implementation*/
+
+#include "lazy_string.hpp"
+
+namespace nx{
+
+/**@class LazyString
+ * @brief Bytes tagged with their encoding, decoded on the first wide
+ * access
+ *
+ * Text that is only passed through or compared never becomes wide:
+ * converting into the encoding it came in returns the bytes as they are,
+ * converting into another one transcodes byte to byte (see
+ * transcode.hpp), ASCII text is copied. The wide string is built by the
+ * first toString() call and kept:
+ * @code
+ * LazyString name(row.field, LazyString::cp1251);
+ * out << name.toCP1251();         // no conversion
+ * json << name.toUTF8();          // cp1251 -> UTF-8, no wide string
+ * name.toString().toUpper();      // decoded once from now on
+ * @endcode
+ * Decoding and the conversions the transcoders can't make (unmapped
+ * bytes, invalid UTF-8, characters missing in the target) go through the
+ * corresponding String functions, so the results are those of String.
+ * The wide string is built inside const functions: share LazyString
+ * between threads only after toString() was called.*/
+
+LazyString::LazyString()
+	: tag(none),
+	  has_wide(true)
+{
+}
+
+/**@brief Construct LazyString from bytes in encoding enc.*/
+LazyString::LazyString(const std::string& bytes, Encoding enc)
+	: raw(bytes),
+	  tag(enc),
+	  has_wide(false)
+{
+	assert(enc != none);
+}
+
+/**@brief Construct LazyString from null-terminated bytes in encoding
+ * enc.*/
+LazyString::LazyString(const char* bytes, Encoding enc)
+	: raw(bytes),
+	  tag(enc),
+	  has_wide(false)
+{
+	assert(enc != none);
+}
+
+#if __cplusplus >= 201103L
+/**@brief Construct LazyString taking the storage of bytes in encoding
+ * enc.*/
+LazyString::LazyString(std::string&& bytes, Encoding enc)
+	: raw(std::move(bytes)),
+	  tag(enc),
+	  has_wide(false)
+{
+	assert(enc != none);
+}
+#endif
+
+/**@brief Construct LazyString from String, it is encoded on conversion.*/
+LazyString::LazyString(const String& str)
+	: tag(none),
+	  wide(str),
+	  has_wide(true)
+{
+}
+
+/**@brief The wide string, decoded on the first call.*/
+const String& LazyString::toString() const
+{
+	if(has_wide)
+		return wide;
+	switch(tag)
+	{
+		case utf8:   wide = String::fromUTF8(raw);   break;
+		case cp1251: wide = String::fromCP1251(raw); break;
+		case cp866:  wide = String::fromCP866(raw);  break;
+		case ascii:  wide = String::fromASCII(raw);  break;
+		case none:   break;
+	}
+	has_wide = true;
+	return wide;
+}
+
+/**@brief Convert into encoding enc.
+ *
+ * Bytes already in enc are returned as received, ASCII bytes are copied,
+ * the others are transcoded without decoding when possible.*/
+std::string LazyString::to(Encoding enc) const
+{
+	assert(enc != none);
+	if(tag != none)
+	{
+		if(enc == tag || utf8_ascii_length(raw.data(), raw.data()
+		                                   + raw.size()) == raw.size())
+			return raw;
+		std::string result;
+		if(transcode(enc, result))
+			return result;
+	}
+	switch(enc)
+	{
+		case utf8:   return toString().toUTF8();
+		case cp1251: return toString().toCP1251();
+		case cp866:  return toString().toCP866();
+		case ascii:  return toString().toASCII();
+		case none:   break;
+	}
+	return std::string();
+}
+
+/**@brief Transcode bytes into encoding enc without decoding.
+ * @return false if there is no transcoder from tag to enc or it failed
+ * on the bytes*/
+bool LazyString::transcode(Encoding enc, std::string& result) const
+{
+	typedef std::codecvt_base::result (*transcoder)(const char*, const char*,
+	                                                const char*&, char*, char*,
+	                                                char*&);
+	transcoder f = 0;
+	size_t ratio = 1; // output bytes per input byte at most
+	if(tag == cp1251 && enc == cp866)
+		f = &sbcs_transcode<sbcs_cp1251, sbcs_cp866>;
+	else if(tag == cp866 && enc == cp1251)
+		f = &sbcs_transcode<sbcs_cp866, sbcs_cp1251>;
+	else if(tag == cp1251 && enc == utf8)
+	{
+		f = &sbcs_to_utf8<sbcs_cp1251>;
+		ratio = 3;
+	}
+	else if(tag == cp866 && enc == utf8)
+	{
+		f = &sbcs_to_utf8<sbcs_cp866>;
+		ratio = 3;
+	}
+	else if(tag == utf8 && enc == cp1251)
+		f = &utf8_to_sbcs<sbcs_cp1251>;
+	else if(tag == utf8 && enc == cp866)
+		f = &utf8_to_sbcs<sbcs_cp866>;
+	if(f == 0 || raw.empty())
+		return false;
+	result.resize(raw.size() * ratio);
+	const char* from = raw.data();
+	char* to = &result[0];
+	if(f(from, raw.data() + raw.size(), from,
+	     to, &result[0] + result.size(), to) != std::codecvt_base::ok)
+		return false;
+	result.resize(to - &result[0]);
+	return true;
+}
+
+/**@brief Compare strings, bytes in the same encoding are compared as
+ * they are, without decoding.*/
+bool LazyString::operator==(const LazyString& str) const
+{
+	if(tag != none && tag == str.tag)
+		return raw == str.raw;
+	return toString() == str.toString();
+}
+
+} //namespace nx
@@ -0,0 +1,130 @@
+/**@file include/lazy_string.hpp
+ * @author Nosov Yuri <hoxnox@gmail.com>
+ * @date 2026-10-17
+ * @copyright (c) 2026 Nosov Yuri <hoxnox@gmail.com>
+ * @licence Querier licence
+ *
+ * @brief Encoded string decoded on demand.*/
+
+#ifndef __NX_LAZY_STRING_H__
+#define __NX_LAZY_STRING_H__
+
+#include "string.hpp"
+
+// hoxnox codecvt facets to transcode without decoding
+#include <codecvt/transcode.hpp>
+
+// STL
+#include <string>
+
+namespace nx{
+
+class LazyString
+{
+public:
+
+	/**@brief Encoding of the bytes.*/
+	enum Encoding
+	{
+		utf8,
+		cp1251,
+		cp866,
+		ascii,
+		none   // constructed from String, there are no bytes
+	};
+
+	/**@name ctors
+	 * @{*/
+	LazyString();
+	LazyString(const std::string& bytes, Encoding enc);
+	LazyString(const char* bytes, Encoding enc);
+#if __cplusplus >= 201103L
+	LazyString(std::string&& bytes, Encoding enc);
+#endif
+	LazyString(const String& str);
+	/**@}*/
+
+	/**@name access
+	 * @{*/
+	Encoding encoding() const;
+	const std::string& bytes() const;
+	bool empty() const;
+	bool decoded() const;
+	const String& toString() const;
+	/**@}*/
+
+	/**@name converting to std string
+	 * @{*/
+	std::string to(Encoding enc) const;
+	std::string toUTF8() const;
+	std::string toCP1251() const;
+	std::string toCP866() const;
+	std::string toASCII() const;
+	/**@}*/
+
+	bool operator==(const LazyString& str) const;
+	bool operator!=(const LazyString& str) const;
+
+private:
+
+	bool transcode(Encoding enc, std::string& result) const;
+
+	std::string raw;         // bytes as received
+	Encoding tag;            // encoding of raw
+	mutable String wide;     // decoded raw, valid with has_wide
+	mutable bool has_wide;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// inline
+
+inline LazyString::Encoding LazyString::encoding() const
+{
+	return tag;
+}
+
+/**@brief Bytes as received, empty for strings constructed from String.*/
+inline const std::string& LazyString::bytes() const
+{
+	return raw;
+}
+
+inline bool LazyString::empty() const
+{
+	return tag == none ? wide.empty() : raw.empty();
+}
+
+/**@brief Is the wide string already there, so toString() is free.*/
+inline bool LazyString::decoded() const
+{
+	return has_wide;
+}
+
+inline std::string LazyString::toUTF8() const
+{
+	return to(utf8);
+}
+
+inline std::string LazyString::toCP1251() const
+{
+	return to(cp1251);
+}
+
+inline std::string LazyString::toCP866() const
+{
+	return to(cp866);
+}
+
+inline std::string LazyString::toASCII() const
+{
+	return to(ascii);
+}
+
+inline bool LazyString::operator!=(const LazyString& str) const
+{
+	return !operator==(str);
+}
+
+} // namespace nx
+
+#endif // __NX_LAZY_STRING_H__
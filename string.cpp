@@ -67,68 +67,48 @@ String::String(size_t n, wchar_t c)
 {
 }
 
+#if __cplusplus >= 201103L
+/**@brief Move constructor.*/
+String::String(String&& str) noexcept
+	: std::basic_string<wchar_t>(std::move(str))
+{
+}
+
+/**@brief Construct String taking the storage of std::wstring.*/
+String::String(std::wstring&& str) noexcept
+	: std::basic_string<wchar_t>(std::move(str))
+{
+}
+#endif
+
 String::~String()
 {
 }
 
-/**@brief Constructs String from UTF-8 byte sequence.*/
+/**@brief Constructs String from UTF-8 byte sequence.
+ *
+ * Invalid and truncated sequences are replaced with U+FFFD.*/
 String String::fromUTF8(const char* str)
 {
-	size_t str_l = strlen(str);
-	if(str_l == 0)
-		return String();
-	std::basic_string<wchar_t> wstr;
-	if(mbstowcs(str, str + str_l, std::back_inserter(wstr))
-		== str + str_l)
-		assert(true);
-	return wstr;
+	cvt_status status;
+	return fromUTF8<cvt_replace>(str, status);
 }
 
 /**@brief Constructs String from cp1251 byte sequence.*/
 String String::fromCP1251(const char* str)
 {
-	size_t str_l = strlen(str);
-	if(str_l == 0)
-		return String();
-
-	// converting, using codecvt facets
-	mbstate_t tmp;
-	const char * cnext;
-	wchar_t * wnext;
-	wchar_t *wstr = new wchar_t[str_l + 1];
-	std::uninitialized_fill(wstr, wstr + str_l + 1, 0);
-	typedef std::codecvt<wchar_t, char, mbstate_t> cvt;
-	cvt::result res =
-	    std::use_facet<cvt>(cp1251).in(tmp, str, str + str_l, cnext,
-	                                                 wstr, wstr + str_l, wnext);
-	assert(res == cvt::ok);
-	String result(wstr);
-	delete [] wstr;
-
+	cvt_status status;
+	String result = fromCP1251<cvt_stop>(str, status);
+	assert(status.errors == 0);
 	return result;
 }
 
 /**@brief Constructs String from cp866 byte sequence.*/
 String String::fromCP866(const char* str)
 {
-	size_t str_l = strlen(str);
-	if(str_l == 0)
-		return String();
-
-	// converting, using codecvt facets
-	mbstate_t tmp;
-	const char * cnext;
-	wchar_t * wnext;
-	wchar_t *wstr = new wchar_t[str_l + 1];
-	std::uninitialized_fill(wstr, wstr + str_l + 1, 0);
-	typedef std::codecvt<wchar_t, char, mbstate_t> cvt;
-	cvt::result res =
-	    std::use_facet<cvt>(cp866).in(tmp, str, str + str_l, cnext,
-	                                           wstr, wstr + str_l, wnext);
-	assert(res == cvt::ok);
-	String result(wstr);
-	delete [] wstr;
-
+	cvt_status status;
+	String result = fromCP866<cvt_stop>(str, status);
+	assert(status.errors == 0);
 	return result;
 }
 
@@ -166,26 +146,11 @@ String String::fromNumber(long num)
 
 /**@brief Constructs String from byte sequence, using the locale codecvt
  * facet.*/
-String String::fromByteArray(const ByteArray& bytes, std::locale loc)
+String String::fromByteArray(const ByteArray& bytes, const std::locale& loc)
 {
-	if(bytes.empty())
-		return String();
-
-	// converting, using codecvt facets
-	size_t bsize = bytes.size();
-	mbstate_t tmp;
-	const char * cnext;
-	wchar_t * wnext;
-	wchar_t *wstr = new wchar_t[bsize + 1];
-	std::uninitialized_fill(wstr, wstr + bsize + 1, 0);
-	typedef std::codecvt<wchar_t, char, mbstate_t> cvt;
-	std::vector<char> charr = barr2charr(bytes);
-	cvt::result res =
-	    std::use_facet<cvt>(loc).in(tmp, &charr[0], &charr[0] + bsize, cnext,
-	                                     wstr, wstr + bsize, wnext);
-	assert(res == cvt::ok);
-	String result(wstr);
-	delete [] wstr;
+	cvt_status status;
+	String result = fromByteArray<cvt_stop>(bytes, loc, status);
+	assert(status.errors == 0);
 	return result;
 }
 
@@ -220,62 +185,32 @@ std::string String::toUTF8() const
 {
 	if(std::basic_string<wchar_t>::empty())
 		return std::string();
-	std::string str;
-	if(wcstombs(std::basic_string<wchar_t>::begin(),
-	                std::basic_string<wchar_t>::end(),
-	                std::back_inserter(str))
-	       == std::basic_string<wchar_t>::end())
+	const wchar_t *wstr = std::basic_string<wchar_t>::c_str();
+	const size_t wstr_l = std::basic_string<wchar_t>::length();
+	std::string result(utf8_byte_count(wstr, wstr + wstr_l), '\0');
+	if(result.empty())
+		return result;
+	char *str_end = &result[0];
+	if(wcstombs(wstr, wstr + wstr_l, &result[0], str_end) == wstr + wstr_l)
 		assert(true);
-	return str;
+	return result;
 }
 
 /**@brief Converts String into cp1251 byte sequence.*/
 std::string String::toCP1251() const
 {
-	if(std::basic_string<wchar_t>::empty())
-		return std::string();
-	// converting, using codecvt facets
-	const wchar_t *wstr = std::basic_string<wchar_t>::c_str();
-	const size_t wstr_l = std::basic_string<wchar_t>::length();
-	mbstate_t tmp;
-	char * cnext;
-	const wchar_t * wnext;
-	// wchar_t symol extends maximum to 4 char
-	char *str = new char[wstr_l*4 + 1];
-	std::uninitialized_fill(str, str + wstr_l*4 + 1, 0);
-	typedef std::codecvt<wchar_t, char, mbstate_t> cvt;
-	cvt::result res =
-	    std::use_facet<cvt>(cp1251).out(tmp, wstr, wstr + wstr_l, wnext,
-	                                             str, str + wstr_l*4, cnext);
-	assert(res == cvt::ok);
-	std::string result(str);
-	delete [] str;
-
+	cvt_status status;
+	std::string result = toCP1251<cvt_stop>(status);
+	assert(status.errors == 0);
 	return result;
 }
 
 /**@brief Converts String into cp866 byte sequence.*/
 std::string String::toCP866() const
 {
-	if(std::basic_string<wchar_t>::empty())
-		return std::string();
-	// converting, using codecvt facets
-	const wchar_t *wstr = std::basic_string<wchar_t>::c_str();
-	const size_t wstr_l = std::basic_string<wchar_t>::length();
-	mbstate_t tmp;
-	char * cnext;
-	const wchar_t * wnext;
-	// wchar_t symol extends maximum to 4 char
-	char *str = new char[wstr_l*4 + 1];
-	std::uninitialized_fill(str, str + wstr_l*4 + 1, 0);
-	typedef std::codecvt<wchar_t, char, mbstate_t> cvt;
-	cvt::result res =
-	    std::use_facet<cvt>(cp866).out(tmp, wstr, wstr + wstr_l, wnext,
-	                                            str, str + wstr_l*4, cnext);
-	assert(res == cvt::ok);
-	std::string result(str);
-	delete [] str;
-
+	cvt_status status;
+	std::string result = toCP866<cvt_stop>(status);
+	assert(status.errors == 0);
 	return result;
 }
 
@@ -355,12 +290,35 @@ std::ostream& operator<<(std::ostream& os, const String& str)
 }
 
 /**@brief Оперетор присваивания.*/
-String& String::operator=(const String str)
+String& String::operator=(const String& str)
 {
 	std::basic_string<wchar_t>::assign(str);
 	return *this;
 }
 
+/**@brief Assign const wchar_t*, without a temporary String.*/
+String& String::operator=(const wchar_t* s)
+{
+	std::basic_string<wchar_t>::assign(s);
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+/**@brief Move assignment operator.*/
+String& String::operator=(String&& str) noexcept
+{
+	std::basic_string<wchar_t>::operator=(std::move(str));
+	return *this;
+}
+
+/**@brief Assign std::wstring, taking its storage.*/
+String& String::operator=(std::wstring&& str) noexcept
+{
+	std::basic_string<wchar_t>::operator=(std::move(str));
+	return *this;
+}
+#endif
+
 /**@brief Преобразует строку в число, считая основание base.
  * @base может принимать значения 2-16
  * Если строка не является числом с заданным основанием, возвращает 0.*/
@@ -439,7 +397,7 @@ unsigned long String::toNumber(unsigned char base /*=10*/) const
  * str = L"Иванов Иван Иванович";
  * str.field(L"##", 1); // возвращает строку L"Иванов Иван Иванович"
  * @endcode*/
-String String::field(const String separator, const size_t n) const
+String String::field(const String& separator, const size_t n) const
 {
 	String str(*this);
 	if(n == 0 || str.length() < separator.length())
@@ -468,9 +426,13 @@ String String::field(const String separator, const size_t n) const
 	return String(prev, i);
 }
 
-/**@brief trim the string*/
-String String::trim()
+/**@brief Bounds of the trimmed string: its first character pos and
+ * length n*/
+void String::trimmed(size_t& pos, size_t& n) const
 {
+	pos = n = 0;
+	if(empty())
+		return;
 	size_t begin = 0, end = size() - 1;
 	while( begin < size() && (operator[](begin) == L' ' || operator[](begin) == L'\t') )
 		++begin;
@@ -479,30 +441,114 @@ String String::trim()
 		--end;
 	}
 	if(end - begin > 0)
-		return String(substr(begin, end - begin + 1));
-	else
-		return String();
+	{
+		pos = begin;
+		n = std::min(end - begin + 1, size() - begin);
+	}
+}
+
+/**@brief trim the string*/
+String String::trim() const NX_STRING_LVALUE
+{
+	size_t pos, n;
+	trimmed(pos, n);
+	return substr(pos, n);
 }
 
 /**@brief Convert to upper*/
-String String::toUpper()
+String String::toUpper() const NX_STRING_LVALUE
 {
-	String result;
-	const std::locale ctype_loc(std::locale(), new ctype_unicode);
-	for(size_t i = 0; i < length(); ++i)
-		result += toupper(operator[](i), ctype_loc);
+	String result(*this);
+	if(!result.empty())
+		case_map(data(), data() + size(), &result[0], case_to_upper);
 	return result;
 }
 
 /**@brief Convert to lower*/
-String String::toLower()
+String String::toLower() const NX_STRING_LVALUE
 {
-	String result;
-	const std::locale ctype_loc(std::locale(), new ctype_unicode);
-	for(size_t i = 0; i < length(); ++i)
-		result += tolower(operator[](i), ctype_loc);
+	String result(*this);
+	if(!result.empty())
+		case_map(data(), data() + size(), &result[0], case_to_lower);
 	return result;
 }
 
+#if __cplusplus >= 201103L
+/**@brief trim the temporary string in place*/
+String String::trim() &&
+{
+	size_t pos, n;
+	trimmed(pos, n);
+	erase(pos + n);
+	erase(0, pos);
+	return std::move(*this);
+}
+
+/**@brief Convert the temporary string to upper in place*/
+String String::toUpper() &&
+{
+	if(!empty())
+	{
+		wchar_t* s = &(*this)[0];
+		case_map(s, s + size(), s, case_to_upper);
+	}
+	return std::move(*this);
+}
+
+/**@brief Convert the temporary string to lower in place*/
+String String::toLower() &&
+{
+	if(!empty())
+	{
+		wchar_t* s = &(*this)[0];
+		case_map(s, s + size(), s, case_to_lower);
+	}
+	return std::move(*this);
+}
+#endif
+
+/**@brief Compare with str ignoring case
+ * @return negative, zero or positive, like compare()
+ *
+ * Strings are compared by full case folding, so "Straße" equals
+ * "STRASSE". Nothing is allocated.*/
+int String::compareIgnoreCase(const String& str) const
+{
+	return case_fold_compare(data(), data() + size(),
+	                         str.data(), str.data() + str.size());
+}
+
+/**@brief Is str equal to this string ignoring case, see
+ * compareIgnoreCase()*/
+bool String::equalsIgnoreCase(const String& str) const
+{
+	return case_fold_equal(data(), data() + size(),
+	                       str.data(), str.data() + str.size());
+}
+
+/**@brief Hash of the string ignoring case: equal for strings equal by
+ * equalsIgnoreCase()*/
+size_t String::hashIgnoreCase() const
+{
+	return case_fold_hash(data(), data() + size());
+}
+
+/**@brief Find str ignoring case, starting at pos
+ * @return position of the first occurrence, npos if there is none
+ *
+ * Characters are compared by simple case folding, one for one, so "ß"
+ * does not match "ss". Nothing is allocated.*/
+size_t String::findIgnoreCase(const String& str, size_t pos /* = 0*/) const
+{
+	if(pos > size())
+		return npos;
+	const wchar_t *b = data(), *e = data() + size();
+	const wchar_t* i = case_fold_find(b + pos, e,
+	                                  str.data(), str.data() + str.size());
+	if(i == e && !str.empty())
+		return npos;
+	return i - b;
+}
+
 } //namespace nx
 
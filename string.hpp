@@ -15,6 +15,7 @@
 #include <codecvt/codecvt_cp1251.hpp>
 #include <codecvt/codecvt_cp866.hpp>
 #include <codecvt/mbwcvt.hpp>
+#include <ctype/case_fold.hpp>
 #include <ctype/ctype_unicode.hpp>
 
 
@@ -26,9 +27,19 @@
 #include <limits>
 #include <sstream>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 
+/**@def NX_STRING_LVALUE
+ * @brief Reference qualifier of the member functions having rvalue
+ * overloads, empty before C++11.*/
+#if __cplusplus >= 201103L
+#define NX_STRING_LVALUE &
+#else
+#define NX_STRING_LVALUE
+#endif
+
 namespace nx{
 
 /**@brief Replacement for L"".*/
@@ -68,6 +79,10 @@ public:
 	String(const wchar_t * s, size_t n);
 	String(const wchar_t * s);
 	String(size_t n, wchar_t c);
+#if __cplusplus >= 201103L
+	String(String&& str) noexcept;
+	String(std::wstring&& str) noexcept;
+#endif
 	template<class InputIterator>
 		String (InputIterator begin, InputIterator end);
 	~String();
@@ -75,21 +90,47 @@ public:
 
 	/**@name assigment operators
 	 * @{ */
-	String& operator=(const String str);
+	String& operator=(const String& str);
+	String& operator=(const wchar_t* s);
+#if __cplusplus >= 201103L
+	String& operator=(String&& str) noexcept;
+	String& operator=(std::wstring&& str) noexcept;
+#endif
 	/**@} */
 
 	/**@name "from" constructors
 	 * @{ */
 	static String fromUTF8(const char* str);
 	static String fromUTF8(const std::string& str);
+	template<cvt_error_policy policy>
+		static String fromUTF8(const char* str, cvt_status& status);
+	template<cvt_error_policy policy>
+		static String fromUTF8(const std::string& str, cvt_status& status);
 	static String fromCP1251(const char* str);
 	static String fromCP1251(const std::string& str);
+	template<cvt_error_policy policy>
+		static String fromCP1251(const char* str, cvt_status& status);
+	template<cvt_error_policy policy>
+		static String fromCP1251(const std::string& str, cvt_status& status);
 	static String fromCP866(const char* str);
 	static String fromCP866(const std::string& str);
+	template<cvt_error_policy policy>
+		static String fromCP866(const char* str, cvt_status& status);
+	template<cvt_error_policy policy>
+		static String fromCP866(const std::string& str, cvt_status& status);
 	static String fromASCII(const char* str);
 	static String fromASCII(const std::string& str);
+	template<cvt_error_policy policy>
+		static String fromASCII(const char* str, cvt_status& status);
+	template<cvt_error_policy policy>
+		static String fromASCII(const std::string& str, cvt_status& status);
 	static String fromNumber(long number);
-	static String fromByteArray(const ByteArray& bytes, std::locale loc);
+	static String fromByteArray(const ByteArray& bytes,
+	                            const std::locale& loc);
+	template<cvt_error_policy policy>
+		static String fromByteArray(const ByteArray& bytes,
+		                            const std::locale& loc,
+		                            cvt_status& status);
 	static String fromByteArray(const ByteArray& bytes);
 	/**@} */
 
@@ -97,8 +138,14 @@ public:
 	 * @{*/
 	std::string toUTF8() const;
 	std::string toCP1251() const;
+	template<cvt_error_policy policy>
+		std::string toCP1251(cvt_status& status) const;
 	std::string toCP866() const;
+	template<cvt_error_policy policy>
+		std::string toCP866(cvt_status& status) const;
 	std::string toASCII() const;
+	template<cvt_error_policy policy>
+		std::string toASCII(cvt_status& status) const;
 	unsigned long toNumber(unsigned char base = 10) const;
 	/**@}*/
 
@@ -109,10 +156,69 @@ public:
 	static const std::locale cp866;
 
 	String substr(size_t pos = 0, size_t n = npos) const;
-	String field(const String separator, const size_t n) const;
-	String trim();
-	String toUpper();
-	String toLower();
+	String field(const String& separator, const size_t n) const;
+	String trim() const NX_STRING_LVALUE;
+	String toUpper() const NX_STRING_LVALUE;
+	String toLower() const NX_STRING_LVALUE;
+#if __cplusplus >= 201103L
+	String trim() &&;
+	String toUpper() &&;
+	String toLower() &&;
+#endif
+
+	/**@name comparing ignoring case
+	 * @{*/
+	int compareIgnoreCase(const String& str) const;
+	bool equalsIgnoreCase(const String& str) const;
+	size_t hashIgnoreCase() const;
+	size_t findIgnoreCase(const String& str, size_t pos = 0) const;
+	/**@}*/
+
+private:
+
+	typedef std::codecvt<wchar_t, char, mbstate_t> cvt;
+
+	void trimmed(size_t& pos, size_t& n) const;
+
+	/**@brief Codec calling the codecvt facet of a locale*/
+	struct facet_codec
+	{
+		const cvt& facet;
+
+		explicit facet_codec(const cvt& f)
+			: facet(f)
+		{
+		}
+
+		cvt::result in(const char* from, const char* from_end,
+		               const char* &from_next, wchar_t* to, wchar_t* to_end,
+		               wchar_t* &to_next) const
+		{
+			mbstate_t state = mbstate_t();
+			return facet.in(state, from, from_end, from_next,
+			                to, to_end, to_next);
+		}
+
+		cvt::result out(const wchar_t* from, const wchar_t* from_end,
+		                const wchar_t* &from_next, char* to, char* to_end,
+		                char* &to_next) const
+		{
+			mbstate_t state = mbstate_t();
+			return facet.out(state, from, from_end, from_next,
+			                 to, to_end, to_next);
+		}
+
+		int max_length() const
+		{
+			return facet.max_length();
+		}
+	};
+
+	template<cvt_error_policy policy, class Codec>
+		static String decode(const char* str, const char* str_end,
+		                     const Codec& codec, cvt_status& status);
+	template<cvt_error_policy policy, class Codec>
+		std::string encode(const Codec& codec, cvt_status& status) const;
 };
 
 std::ostream& operator<<(std::ostream& os, const String& str);
@@ -140,6 +246,251 @@ inline String String::fromUTF8(const std::string& str)
 	return fromUTF8(str.c_str());
 }
 
+/**@brief Constructs String from UTF-8 byte sequence, validating it.
+ * @param status receives the number of invalid sequences and the offset
+ * of the first one
+ *
+ * Invalid sequences are handled according to policy, with cvt_stop the
+ * result holds the characters before the first one.*/
+template<cvt_error_policy policy>
+	String String::fromUTF8(const char* str, cvt_status& status)
+{
+	const size_t str_l = strlen(str);
+	if(str_l == 0)
+		return String();
+	// exact for valid input, replacement characters may need more
+	String result;
+	result.resize(std::max<size_t>(
+		utf8_unit_count<wchar_t>(str, str + str_l), 1));
+	const char *from = str, *from_end = str + str_l;
+	const size_t base = status.base;
+	size_t done = 0;
+	for(;;)
+	{
+		wchar_t *to = &result[0] + done;
+		std::codecvt_base::result res = utf8_in<policy>(from, from_end, from,
+		                                   to, &result[0] + result.size(), to,
+		                                   status);
+		done = to - &result[0];
+		if(res != std::codecvt_base::partial)
+			break;
+		status.base = base + (from - str);
+		result.resize(done + (from_end - from));
+	}
+	status.base = base;
+	result.resize(done);
+	return result;
+}
+
+template<cvt_error_policy policy>
+	String String::fromUTF8(const std::string& str, cvt_status& status)
+{
+	return fromUTF8<policy>(str.c_str(), status);
+}
+
+/**@brief Translates [str, str_end) with the codec, handling bytes it
+ * can't convert according to policy.
+ *
+ * Bad bytes are replaced with U+FFFD one by one, or skipped, with
+ * cvt_stop the result holds the characters before the first one.*/
+template<cvt_error_policy policy, class Codec>
+	String String::decode(const char* str, const char* str_end,
+	                      const Codec& codec, cvt_status& status)
+{
+	if(str == str_end)
+		return String();
+	// a character takes at least one byte, so does a replacement
+	String result;
+	result.resize(str_end - str);
+	const char *from = str;
+	wchar_t *to = &result[0], *to_end = &result[0] + result.size();
+	while(from != str_end)
+	{
+		const cvt::result res = codec.in(from, str_end, from, to, to_end, to);
+		if(res == cvt::ok)
+			break;
+		// error, or a sequence cut by the end of input
+		status.fail(status.base + (from - str));
+		if(policy == cvt_stop)
+			break;
+		if(policy == cvt_replace)
+			*to++ = static_cast<wchar_t>(0xFFFD);
+		++from;
+	}
+	result.resize(to - &result[0]);
+	return result;
+}
+
+/**@brief Translates String with the codec, handling characters it can't
+ * convert according to policy.
+ *
+ * Bad characters are replaced with '?' one by one, or skipped, with
+ * cvt_stop the result holds the bytes before the first one.*/
+template<cvt_error_policy policy, class Codec>
+	std::string String::encode(const Codec& codec, cvt_status& status) const
+{
+	if(empty())
+		return std::string();
+	const wchar_t *from = data(), *from_end = data() + size();
+	std::string result(size() * std::max(codec.max_length(), 1), '\0');
+	char *to = &result[0], *to_end = &result[0] + result.size();
+	while(from != from_end)
+	{
+		const cvt::result res = codec.out(from, from_end, from,
+		                                  to, to_end, to);
+		if(res == cvt::ok)
+			break;
+		status.fail(status.base + (from - data()));
+		if(policy == cvt_stop)
+			break;
+		if(policy == cvt_replace)
+			*to++ = '?';
+		++from;
+	}
+	result.resize(to - &result[0]);
+	return result;
+}
+
+/**@brief Constructs String from cp1251 byte sequence.
+ * @param status receives the number of unmapped bytes and the offset of
+ * the first one
+ *
+ * Unmapped bytes are handled according to policy, see decode().*/
+template<cvt_error_policy policy>
+	String String::fromCP1251(const char* str, cvt_status& status)
+{
+	return decode<policy>(str, str + strlen(str),
+	                      codec_cp1251(), status);
+}
+
+template<cvt_error_policy policy>
+	String String::fromCP1251(const std::string& str, cvt_status& status)
+{
+	return decode<policy>(str.data(), str.data() + str.size(),
+	                      codec_cp1251(), status);
+}
+
+/**@brief Constructs String from cp866 byte sequence.
+ * @param status receives the number of unmapped bytes and the offset of
+ * the first one
+ *
+ * Unmapped bytes are handled according to policy, see decode().*/
+template<cvt_error_policy policy>
+	String String::fromCP866(const char* str, cvt_status& status)
+{
+	return decode<policy>(str, str + strlen(str),
+	                      codec_cp866(), status);
+}
+
+template<cvt_error_policy policy>
+	String String::fromCP866(const std::string& str, cvt_status& status)
+{
+	return decode<policy>(str.data(), str.data() + str.size(),
+	                      codec_cp866(), status);
+}
+
+/**@brief Constructs String from ascii byte sequence.
+ * @param status receives the number of non-ASCII bytes and the offset of
+ * the first one
+ *
+ * Non-ASCII bytes are handled according to policy, the replacement is
+ * U+FFFD.*/
+template<cvt_error_policy policy>
+	String String::fromASCII(const char* str, cvt_status& status)
+{
+	const size_t str_l = strlen(str);
+	String result;
+	result.reserve(str_l);
+	for(size_t i = 0; i < str_l; ++i)
+	{
+		const unsigned char c = static_cast<unsigned char>(str[i]);
+		if(c <= 127)
+		{
+			result += static_cast<wchar_t>(c);
+			continue;
+		}
+		status.fail(status.base + i);
+		if(policy == cvt_stop)
+			break;
+		if(policy == cvt_replace)
+			result += static_cast<wchar_t>(0xFFFD);
+	}
+	return result;
+}
+
+template<cvt_error_policy policy>
+	String String::fromASCII(const std::string& str, cvt_status& status)
+{
+	return fromASCII<policy>(str.c_str(), status);
+}
+
+/**@brief Constructs String from byte sequence, using the locale codecvt
+ * facet.
+ * @param status receives the number of bytes the facet failed to convert
+ * and the offset of the first one
+ *
+ * Bad bytes are handled according to policy, see decode().*/
+template<cvt_error_policy policy>
+	String String::fromByteArray(const ByteArray& bytes,
+	                             const std::locale& loc, cvt_status& status)
+{
+	if(bytes.empty())
+		return String();
+	const char* str = reinterpret_cast<const char*>(&bytes[0]);
+	return decode<policy>(str, str + bytes.size(),
+	                      facet_codec(std::use_facet<cvt>(loc)), status);
+}
+
+/**@brief Converts String into cp1251 byte sequence.
+ * @param status receives the number of characters missing in cp1251 and
+ * the offset of the first one
+ *
+ * Such characters are handled according to policy, see encode().*/
+template<cvt_error_policy policy>
+	std::string String::toCP1251(cvt_status& status) const
+{
+	return encode<policy>(codec_cp1251(), status);
+}
+
+/**@brief Converts String into cp866 byte sequence.
+ * @param status receives the number of characters missing in cp866 and
+ * the offset of the first one
+ *
+ * Such characters are handled according to policy, see encode().*/
+template<cvt_error_policy policy>
+	std::string String::toCP866(cvt_status& status) const
+{
+	return encode<policy>(codec_cp866(), status);
+}
+
+/**@brief Converts String into ascii byte sequence.
+ * @param status receives the number of non-ASCII characters and the
+ * offset of the first one
+ *
+ * Non-ASCII characters are handled according to policy, the replacement
+ * is '?'.*/
+template<cvt_error_policy policy>
+	std::string String::toASCII(cvt_status& status) const
+{
+	std::string result;
+	result.reserve(size());
+	for(size_t i = 0; i < size(); ++i)
+	{
+		const unsigned long c = static_cast<unsigned long>((*this)[i]);
+		if(c <= 127)
+		{
+			result += static_cast<char>(c);
+			continue;
+		}
+		status.fail(status.base + i);
+		if(policy == cvt_stop)
+			break;
+		if(policy == cvt_replace)
+			result += '?';
+	}
+	return result;
+}
+
 inline String String::substr(size_t pos, size_t n) const
 {
 	return std::basic_string<wchar_t>::substr(pos, n);
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Generate a single-byte codepage table for codecvt_sbcs.
+
+Reads a mapping file in the unicode.org format (e.g.
+MAPPINGS/VENDORS/MICSFT/WINDOWS/CP1251.TXT or MAPPINGS/ISO8859/8859-5.TXT):
+
+    0x80	0x0402	#CYRILLIC CAPITAL LETTER DJE
+
+and writes the upper half of the codepage (bytes 0x80..0xFF) as an
+X-macro file, one SBCS_MAP(byte, code point) per byte. Unmapped bytes get
+code point 0. The lower half must be ASCII.
+
+With --codec the mapping is taken from a Python codec instead of a file.
+
+Usage:
+    sbcs_def.py CP1251.TXT cp1251 > facet/codecvt/sbcs/cp1251.def
+    sbcs_def.py --codec koi8_u koi8u > facet/codecvt/sbcs/koi8u.def
+"""
+
+import sys
+import unicodedata
+
+
+def read_mapping(path):
+    mapping = {}
+    with open(path, encoding='latin-1') as f:
+        for line in f:
+            line = line.split('#', 1)[0].split()
+            if len(line) < 2:
+                continue
+            mapping[int(line[0], 16)] = int(line[1], 16)
+    return mapping
+
+
+def codec_mapping(codec):
+    mapping = {}
+    for b in range(256):
+        try:
+            mapping[b] = ord(bytes([b]).decode(codec))
+        except UnicodeDecodeError:
+            pass
+    return mapping
+
+
+def main(argv):
+    if len(argv) != (3 if argv[:1] == ['--codec'] else 2):
+        sys.exit(__doc__)
+    if argv[0] == '--codec':
+        mapping, source = codec_mapping(argv[1]), 'Python codec ' + argv[1]
+    else:
+        mapping, source = read_mapping(argv[0]), argv[0].split('/')[-1]
+    name = argv[-1]
+    for b in range(0x80):
+        if mapping.get(b, b) != b:
+            sys.exit('%s: byte 0x%02X is not ASCII' % (name, b))
+    out = sys.stdout
+    out.write('/* %s: bytes 0x80..0xFF, generated by tools/sbcs_def.py\n'
+              ' * from %s. Do not edit. */\n' % (name, source))
+    for b in range(0x80, 0x100):
+        cp = mapping.get(b)
+        if cp is None:
+            out.write('SBCS_MAP(0x%02X, 0x0000) // UNDEFINED\n' % b)
+        else:
+            out.write('SBCS_MAP(0x%02X, 0x%04X) // %s\n'
+                      % (b, cp, unicodedata.name(chr(cp), '<control>')))
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
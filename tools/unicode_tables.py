@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Generate the character property tables of ctype_unicode.
+
+Reads UnicodeData.txt and CaseFolding.txt
+(https://www.unicode.org/Public/UCD/latest/ucd/) and writes four X-macro
+files into OUTDIR:
+
+    classes.def  UNICODE_CLASS(props, upper, lower, fold) per character
+                 class: property flags, simple case mapping and case
+                 folding deltas
+    pages.def    class block of each 256-character page, U+0000..U+10FFFF
+    blocks.def   deduplicated blocks, 256 class numbers each
+    folds.def    UNICODE_FOLD(c, f1, f2, f3) per character folding to
+                 several ones (unicode_full_fold in props), sorted by c
+
+Class 0 is unassigned code points. The classification follows POSIX
+character classes applied to the general categories:
+
+    upper   Lu, Lt
+    lower   Ll
+    alpha   L*, Nl
+    digit   0-9
+    xdigit  0-9, A-F, a-f
+    space   tab..carriage return, Zs but no-break spaces, Zl, Zp
+    blank   tab, Zs but no-break spaces
+    cntrl   Cc, Zl, Zp
+    print   all but Cc, Cs, Cn, Zl, Zp
+    graph   print but Zs
+    punct   graph but alpha and digit
+
+Folding is the full one (statuses C and F of CaseFolding.txt), the fold
+delta of a class with unicode_full_fold is 0.
+
+Usage:
+    unicode_tables.py UnicodeData.txt CaseFolding.txt facet/ctype/unicode
+"""
+
+import os
+import re
+import sys
+
+MAX_CP = 0x110000
+PAGE = 256
+
+NBSP = (0x00A0, 0x2007, 0x202F)
+
+
+def read_unicode_data(path):
+    """General category, simple upper and lower mapping of every code
+    point assigned in path."""
+    chars = {}
+    first = None
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            fields = line.rstrip('\n').split(';')
+            cp = int(fields[0], 16)
+            upper = int(fields[12], 16) if fields[12] else cp
+            lower = int(fields[13], 16) if fields[13] else cp
+            record = (fields[2], upper, lower)
+            # ranges are given by their first and last code points
+            if fields[1].endswith(', First>'):
+                first = cp
+                continue
+            if fields[1].endswith(', Last>'):
+                for c in range(first, cp + 1):
+                    chars[c] = record
+                continue
+            chars[cp] = record
+    return chars
+
+
+def read_case_folding(path):
+    """Full case folding of every code point folded in path."""
+    folds = {}
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            fields = [x.strip() for x in line.split('#')[0].split(';')]
+            if len(fields) < 3 or fields[1] not in ('C', 'F'):
+                continue
+            folds[int(fields[0], 16)] = tuple(int(x, 16)
+                                              for x in fields[2].split())
+    return folds
+
+
+def properties(cp, category):
+    props = set()
+    if category in ('Lu', 'Lt'):
+        props.add('upper')
+    if category == 'Ll':
+        props.add('lower')
+    if category[0] == 'L' or category == 'Nl':
+        props.add('alpha')
+    if 0x30 <= cp <= 0x39:
+        props.add('digit')
+    if (0x30 <= cp <= 0x39 or 0x41 <= cp <= 0x46
+            or 0x61 <= cp <= 0x66):
+        props.add('xdigit')
+    if ((category == 'Zs' and cp not in NBSP) or category in ('Zl', 'Zp')
+            or 0x09 <= cp <= 0x0D):
+        props.add('space')
+    if cp == 0x09 or (category == 'Zs' and cp not in NBSP):
+        props.add('blank')
+    if category in ('Cc', 'Zl', 'Zp'):
+        props.add('cntrl')
+    if category not in ('Cc', 'Cs', 'Cn', 'Zl', 'Zp'):
+        props.add('print')
+        if category != 'Zs':
+            props.add('graph')
+            if 'alpha' not in props and 'digit' not in props:
+                props.add('punct')
+    return props
+
+
+FLAGS = ('upper', 'lower', 'alpha', 'digit', 'xdigit', 'space', 'print',
+         'cntrl', 'punct', 'graph', 'blank', 'full_fold')
+
+
+def build(chars, folds):
+    classes = {('0', 0, 0, 0): 0}
+    ids = []
+    for cp in range(MAX_CP):
+        category, upper, lower = chars.get(cp, ('Cn', cp, cp))
+        props = properties(cp, category)
+        fold = folds.get(cp, (cp,))
+        if len(fold) > 1:
+            props.add('full_fold')
+        flags = '|'.join('unicode_' + f for f in FLAGS if f in props) or '0'
+        record = (flags, upper - cp, lower - cp,
+                  fold[0] - cp if len(fold) == 1 else 0)
+        ids.append(classes.setdefault(record, len(classes)))
+    blocks = {}
+    pages = []
+    for p in range(0, MAX_CP, PAGE):
+        block = tuple(ids[p:p + PAGE])
+        pages.append(blocks.setdefault(block, len(blocks)))
+    if len(classes) > 256 or len(blocks) > 256:
+        sys.exit('tables do not fit into bytes: %d classes, %d blocks'
+                 % (len(classes), len(blocks)))
+    return classes, pages, blocks
+
+
+def write_numbers(f, numbers):
+    for i in range(0, len(numbers), 16):
+        f.write(' '.join('%3d,' % n for n in numbers[i:i + 16]) + '\n')
+
+
+def read_version(path):
+    """Unicode version from the header of CaseFolding.txt, if any."""
+    with open(path, encoding='utf-8') as f:
+        match = re.match(r'# CaseFolding-(\d+\.\d+\.\d+)\.txt', f.readline())
+    return ' %s' % match.group(1) if match else ''
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.exit(__doc__)
+    chars = read_unicode_data(argv[0])
+    folds = read_case_folding(argv[1])
+    classes, pages, blocks = build(chars, folds)
+    header = ('/* %%s, generated by tools/unicode_tables.py\n'
+              ' * from UnicodeData.txt and CaseFolding.txt%s.'
+              ' Do not edit. */\n' % read_version(argv[1]))
+    outdir = argv[2]
+    with open(os.path.join(outdir, 'classes.def'), 'w') as f:
+        f.write(header % 'character classes')
+        for record, n in sorted(classes.items(), key=lambda c: c[1]):
+            f.write('UNICODE_CLASS(%s, %d, %d, %d)\n' % record)
+    with open(os.path.join(outdir, 'pages.def'), 'w') as f:
+        f.write(header % 'block of each 256-character page')
+        write_numbers(f, pages)
+    with open(os.path.join(outdir, 'blocks.def'), 'w') as f:
+        f.write(header % 'classes of the characters of each block')
+        for block, n in sorted(blocks.items(), key=lambda b: b[1]):
+            f.write('/* block %d */\n' % n)
+            write_numbers(f, block)
+    with open(os.path.join(outdir, 'folds.def'), 'w') as f:
+        f.write(header % 'characters folding to several ones')
+        for cp, fold in sorted(folds.items()):
+            if len(fold) > 1:
+                f.write('UNICODE_FOLD(0x%04X, %s)\n'
+                        % (cp, ', '.join('0x%04X' % x
+                                         for x in (fold + (0, 0))[:3])))
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])